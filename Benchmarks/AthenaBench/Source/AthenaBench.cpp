@@ -0,0 +1,59 @@
+#include "Benchmark.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void RegisterSceneBenchmarks();
+
+// Usage: AthenaBench [--filter name] [--sizes 1000,10000,100000] [--min-time seconds] [--max-time seconds]
+int main(int argc, char* argv[])
+{
+	Bench::Options options;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = i + 1 < argc;
+		if (strcmp(argv[i], "--filter") == 0 && hasValue)
+		{
+			options.filter = argv[++i];
+		}
+		else if (strcmp(argv[i], "--min-time") == 0 && hasValue)
+		{
+			options.minSeconds = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--max-time") == 0 && hasValue)
+		{
+			options.maxSeconds = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--sizes") == 0 && hasValue)
+		{
+			options.nSizes = 0;
+			char* pCursor = argv[++i];
+			while (*pCursor != '\0' && options.nSizes < 8)
+			{
+				int size = int(strtol(pCursor, &pCursor, 10));
+				if (size > 0)
+					options.sizes[options.nSizes++] = size;
+				if (*pCursor == ',')
+					pCursor++;
+				else
+					break;
+			}
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [--filter name] [--sizes 1000,10000,100000] [--min-time seconds] [--max-time seconds]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	RegisterSceneBenchmarks();
+
+	if (Bench::RunAll(options) == 0)
+	{
+		fprintf(stderr, "No benchmarks matched the filter\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,212 @@
+#include "Benchmark.h"
+
+#include <ErrorHandling.h>
+#include <Scene.h>
+
+#include <SDL_timer.h>
+#include <EASTL/vector.h>
+#include <EASTL/sort.h>
+
+#include <atomic>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+	struct Entry
+	{
+		const char* name;
+		Bench::BenchFunc func;
+	};
+
+	eastl::vector<Entry>& GetEntries()
+	{
+		static eastl::vector<Entry> entries;
+		return entries;
+	}
+
+	// Jobs may allocate from worker threads, so these are atomic
+	std::atomic<uint64_t> g_bytesAllocated{ 0 };
+	std::atomic<uint64_t> g_allocationCount{ 0 };
+
+	const int MIN_SAMPLES = 3;
+
+	void* CountedAlloc(size_t size)
+	{
+		g_bytesAllocated.fetch_add(size, std::memory_order_relaxed);
+		g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+		return malloc(size == 0 ? 1 : size);
+	}
+
+	void* CountedAlignedAlloc(size_t size, size_t alignment)
+	{
+		g_bytesAllocated.fetch_add(size, std::memory_order_relaxed);
+		g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+		if (alignment < sizeof(void*))
+			alignment = sizeof(void*);
+		void* pMemory = nullptr;
+		if (posix_memalign(&pMemory, alignment, size == 0 ? 1 : size) != 0)
+			return nullptr;
+		return pMemory;
+	}
+}
+
+// ***********************************************************************
+
+// Everything goes through malloc and free, so the counted allocations can be freed by any delete
+void* operator new(size_t size)
+{
+	void* pMemory = CountedAlloc(size);
+	if (pMemory == nullptr)
+		throw std::bad_alloc();
+	return pMemory;
+}
+void* operator new[](size_t size)
+{
+	void* pMemory = CountedAlloc(size);
+	if (pMemory == nullptr)
+		throw std::bad_alloc();
+	return pMemory;
+}
+void operator delete(void* pMemory) noexcept { free(pMemory); }
+void operator delete[](void* pMemory) noexcept { free(pMemory); }
+void operator delete(void* pMemory, size_t) noexcept { free(pMemory); }
+void operator delete[](void* pMemory, size_t) noexcept { free(pMemory); }
+
+// EASTL expects us to define these, see allocator.h line 194
+void* operator new[](size_t size, const char* pName, int flags, unsigned debugFlags, const char* file, int line)
+{
+	return CountedAlloc(size);
+}
+void* operator new[](size_t size, size_t alignment, size_t alignmentOffset, const char* pName, int flags, unsigned debugFlags, const char* file, int line)
+{
+	return CountedAlignedAlloc(size, alignment);
+}
+
+// ***********************************************************************
+
+void Bench::State::Start()
+{
+	startBytes = BytesAllocated();
+	startAllocs = AllocationCount();
+	startTime = Now();
+}
+
+// ***********************************************************************
+
+void Bench::State::Stop(uint64_t ops)
+{
+	uint64_t endTime = Now();
+	sampleNs += endTime - startTime;
+	sampleBytes += BytesAllocated() - startBytes;
+	sampleAllocs += AllocationCount() - startAllocs;
+	sampleOps += ops;
+}
+
+// ***********************************************************************
+
+void Bench::Register(const char* name, BenchFunc func)
+{
+	GetEntries().push_back(Entry{ name, func });
+}
+
+// ***********************************************************************
+
+int Bench::RunAll(const Options& options)
+{
+	// The first line describes the run, so results from different builds can be told apart
+	printf("{\"suite\":\"AthenaBench\",\"format\":1,\"max_components\":%d,\"optimized\":%s}\n",
+		MAX_COMPONENTS,
+#ifdef NDEBUG
+		"true"
+#else
+		"false"
+#endif
+	);
+	fflush(stdout);
+
+	int nRun = 0;
+	eastl::vector<double> samples;
+	for (const Entry& entry : GetEntries())
+	{
+		if (options.filter && strstr(entry.name, options.filter) == nullptr)
+			continue;
+
+		for (int i = 0; i < options.nSizes; i++)
+		{
+			State state;
+			state.entityCount = options.sizes[i];
+
+			uint64_t totalOps = 0;
+			uint64_t totalBytes = 0;
+			uint64_t totalAllocs = 0;
+			samples.clear();
+
+			uint64_t runStart = Now();
+			while (true)
+			{
+				state.sampleNs = 0;
+				state.sampleOps = 0;
+				state.sampleBytes = 0;
+				state.sampleAllocs = 0;
+				entry.func(state);
+				ASSERT(state.sampleOps > 0, "Benchmark didn't measure anything, call Start and Stop around the work");
+
+				samples.push_back(double(state.sampleNs) / double(state.sampleOps));
+				totalOps += state.sampleOps;
+				totalBytes += state.sampleBytes;
+				totalAllocs += state.sampleAllocs;
+
+				double elapsed = double(Now() - runStart) * 1e-9;
+				if (elapsed >= options.maxSeconds)
+					break;
+				if (elapsed >= options.minSeconds && samples.size() >= MIN_SAMPLES)
+					break;
+			}
+
+			// The median is reported as it's less noisy than the mean, min is the best case we saw
+			eastl::sort(samples.begin(), samples.end());
+			double median = samples[samples.size() / 2];
+			if (samples.size() % 2 == 0)
+				median = (samples[samples.size() / 2 - 1] + median) * 0.5;
+
+			printf("{\"benchmark\":\"%s\",\"entities\":%d,\"samples\":%d,\"ops\":%llu,\"ns_per_op\":%.3f,\"min_ns_per_op\":%.3f,\"bytes_per_op\":%.3f,\"allocs_per_op\":%.4f,\"resident_bytes\":%llu}\n",
+				entry.name,
+				state.entityCount,
+				int(samples.size()),
+				(unsigned long long)totalOps,
+				median,
+				samples.front(),
+				double(totalBytes) / double(totalOps),
+				double(totalAllocs) / double(totalOps),
+				(unsigned long long)state.residentBytes);
+			fflush(stdout);
+		}
+		nRun++;
+	}
+	return nRun;
+}
+
+// ***********************************************************************
+
+uint64_t Bench::Now()
+{
+	static double nsPerTick = 1e9 / double(SDL_GetPerformanceFrequency());
+	return uint64_t(double(SDL_GetPerformanceCounter()) * nsPerTick);
+}
+
+// ***********************************************************************
+
+uint64_t Bench::BytesAllocated()
+{
+	return g_bytesAllocated.load(std::memory_order_relaxed);
+}
+
+// ***********************************************************************
+
+uint64_t Bench::AllocationCount()
+{
+	return g_allocationCount.load(std::memory_order_relaxed);
+}
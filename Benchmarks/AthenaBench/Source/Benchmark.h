@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// A tiny benchmark harness for the entity system
+// Each benchmark is a function that's called repeatedly, once per sample. It does whatever setup it likes,
+// then wraps the part being measured in Start and Stop, telling Stop how many operations it did.
+// Results are written to stdout as one json object per line, so runs can be diffed and tracked over time
+
+namespace Bench
+{
+	struct State
+	{
+		// How many entities the benchmark should work with
+		int entityCount{ 0 };
+
+		// Marks the measured part of the sample, allocations in between are counted too
+		void Start();
+		void Stop(uint64_t ops);
+
+		// Optional, chunk memory held by the scene being measured
+		size_t residentBytes{ 0 };
+
+		uint64_t startTime{ 0 };
+		uint64_t startBytes{ 0 };
+		uint64_t startAllocs{ 0 };
+
+		uint64_t sampleNs{ 0 };
+		uint64_t sampleOps{ 0 };
+		uint64_t sampleBytes{ 0 };
+		uint64_t sampleAllocs{ 0 };
+	};
+
+	typedef void (*BenchFunc)(State&);
+
+	struct Options
+	{
+		// Only benchmarks with names containing this are run
+		const char* filter{ nullptr };
+
+		// Each benchmark and size is sampled for at least this long
+		double minSeconds{ 0.5 };
+
+		// Unless a single sample is this slow, in which case we take what we've got
+		double maxSeconds{ 5.0 };
+
+		int sizes[8]{ 1000, 10000, 100000 };
+		int nSizes{ 3 };
+	};
+
+	void Register(const char* name, BenchFunc func);
+
+	// Returns the number of benchmarks run
+	int RunAll(const Options& options);
+
+	// Monotonic time in nanoseconds
+	uint64_t Now();
+
+	// Totals since startup, of everything allocated through operator new, including by EASTL
+	uint64_t BytesAllocated();
+	uint64_t AllocationCount();
+}
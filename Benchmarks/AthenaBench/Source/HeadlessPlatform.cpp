@@ -0,0 +1,122 @@
+// The few engine services the core sources call into, without windows, rendering or an asset database
+// Logs go to stderr so stdout only has benchmark results on it
+
+#include <ErrorHandling.h>
+#include <Log.h>
+#include <Engine.h>
+#include <AssetDatabase.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <wchar.h>
+
+namespace
+{
+	Log::LogLevel globalLevel{ Log::EWarn };
+	Log::StringHistoryBuffer logHistory;
+
+	void PrintLog(Log::LogLevel level, const char* prefix, const char* text, va_list args)
+	{
+		if (level > globalLevel)
+			return;
+		fprintf(stderr, "%s", prefix);
+		vfprintf(stderr, text, args);
+		fprintf(stderr, "\n");
+	}
+}
+
+// ***********************************************************************
+
+void Log::SetLogLevel(LogLevel level)
+{
+	globalLevel = level;
+}
+
+void Log::Crit(const char* text, ...)
+{
+	va_list args;
+	va_start(args, text);
+	PrintLog(ECrit, "[CRITICAL] ", text, args);
+	va_end(args);
+}
+
+void Log::Warn(const char* text, ...)
+{
+	va_list args;
+	va_start(args, text);
+	PrintLog(EWarn, "[WARNING] ", text, args);
+	va_end(args);
+}
+
+void Log::Info(const char* text, ...)
+{
+	va_list args;
+	va_start(args, text);
+	PrintLog(EInfo, "[INFO] ", text, args);
+	va_end(args);
+}
+
+void Log::Debug(const char* text, ...)
+{
+	va_list args;
+	va_start(args, text);
+	PrintLog(EDebug, "[DEBUG] ", text, args);
+	va_end(args);
+}
+
+const Log::StringHistoryBuffer& Log::GetLogHistory()
+{
+	return logHistory;
+}
+
+// ***********************************************************************
+
+void Assertion(const char* errorMsg, const char* file, int line)
+{
+	ShowAssertDialog(errorMsg, file, line);
+	abort();
+}
+
+int ShowAssertDialog(const char* errorMsg, const char* file, int line)
+{
+	fprintf(stderr, "Assertion Failed\n\n%s\n\nFile: %s\nLine %i\n", errorMsg, file, line);
+	return 0;
+}
+
+// ***********************************************************************
+
+// A requirement of EASTL that we provide these functions for string::sprintf to work
+int Vsnprintf8(char* p, size_t n, const char* pFormat, va_list arguments)
+{
+	return vsnprintf(p, n, pFormat, arguments);
+}
+
+int Vsnprintf16(char16_t* p, size_t n, const char16_t* pFormat, va_list arguments)
+{
+	return vswprintf((wchar_t*)p, n, (const wchar_t*)pFormat, arguments);
+}
+
+// ***********************************************************************
+
+void Engine::NewSceneCreated(Scene& scene)
+{
+}
+
+// ***********************************************************************
+
+// There are no assets to load, handles just keep their ids so components holding them can be copied
+AssetHandle::AssetHandle(eastl::string identifier) : id(0) {}
+AssetHandle::AssetHandle(uint64_t _id) : id(_id) {}
+AssetHandle::AssetHandle(const AssetHandle& copy) : id(copy.id) {}
+AssetHandle::AssetHandle(AssetHandle&& move) : id(move.id) { move.id = 0; }
+AssetHandle& AssetHandle::operator=(const AssetHandle& copy) { id = copy.id; return *this; }
+AssetHandle& AssetHandle::operator=(AssetHandle&& move) { id = move.id; move.id = 0; return *this; }
+bool AssetHandle::operator==(const AssetHandle& other) { return id == other.id; }
+bool AssetHandle::operator!=(const AssetHandle& other) { return id != other.id; }
+AssetHandle::~AssetHandle() {}
+
+eastl::string AssetDB::GetAssetIdentifier(AssetHandle handle)
+{
+	return "";
+}
@@ -0,0 +1,361 @@
+#include "Benchmark.h"
+
+#include <Scene.h>
+#include <SceneSerializer.h>
+#include <Json.h>
+#include <Vec3.h>
+
+#include <EASTL/vector.h>
+
+// Components only the benchmarks use, so the engine's own can't change underneath them
+struct CVelocity
+{
+	Vec3f velocity{ Vec3f(1.0f, 0.5f, 0.0f) };
+
+	REFLECT()
+};
+
+REFLECT_COMPONENT_BEGIN(CVelocity)
+REFLECT_MEMBER(velocity)
+REFLECT_END()
+
+namespace
+{
+	// How many transforms hang off each other in the deep hierarchy
+	const int HIERARCHY_DEPTH = 32;
+
+	// Deterministic, so every run churns entities in the same order
+	uint32_t NextRandom(uint32_t& state)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	void Shuffle(eastl::vector<EntityID>& ids)
+	{
+		uint32_t random = 0x9E3779B9;
+		for (size_t i = ids.size() - 1; i > 0; i--)
+		{
+			size_t j = NextRandom(random) % (i + 1);
+			eastl::swap(ids[i], ids[j]);
+		}
+	}
+
+	// Gives every root a new position, so the whole tree has to be rebuilt
+	void MoveRoots(Scene& scene)
+	{
+		for (SceneChunk chunk : SceneChunkIterator<CTransform, Without<CChild>>(scene))
+		{
+			CTransform* pTransforms = chunk.Get<CTransform>();
+			for (uint32_t i = 0; i < chunk.Count(); i++)
+				pTransforms[i].localPos.x += 1.0f;
+		}
+	}
+
+	// Named entities with a couple of components, something like a level would have
+	void FillLevel(Scene& scene, int count)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			EntityID id = scene.NewEntity("Entity");
+			scene.Assign<CTransform>(id)->localPos = Vec3f(float(i), 0.0f, 0.0f);
+			scene.Assign<CVelocity>(id);
+		}
+	}
+}
+
+// ***********************************************************************
+
+// Steady state churn, one entity is destroyed and another made in its place per op
+void Bench_EntityChurn(Bench::State& state)
+{
+	Scene scene;
+	eastl::vector<EntityID> ids(state.entityCount);
+	scene.NewEntities<CTransform, CVelocity>(state.entityCount, ids.data());
+	Shuffle(ids);
+
+	state.Start();
+	for (EntityID& id : ids)
+	{
+		scene.DestroyEntity(id);
+		id = scene.NewEntity(nullptr);
+		scene.Assign<CTransform>(id);
+		scene.Assign<CVelocity>(id);
+	}
+	state.Stop(ids.size());
+
+	state.residentBytes = scene.GetResidentBytes();
+}
+
+// ***********************************************************************
+
+void Bench_NewEntities(Bench::State& state)
+{
+	Scene scene;
+	eastl::vector<EntityID> ids(state.entityCount);
+
+	state.Start();
+	scene.NewEntities<CTransform, CVelocity>(state.entityCount, ids.data());
+	state.Stop(ids.size());
+
+	state.residentBytes = scene.GetResidentBytes();
+}
+
+// ***********************************************************************
+
+void Bench_DestroyEntities(Bench::State& state)
+{
+	Scene scene;
+	eastl::vector<EntityID> ids(state.entityCount);
+	scene.NewEntities<CTransform, CVelocity>(state.entityCount, ids.data());
+	Shuffle(ids);
+
+	state.Start();
+	scene.DestroyEntities(ids.data(), ids.size());
+	state.Stop(ids.size());
+}
+
+// ***********************************************************************
+
+// Unloading a level, everything goes at once
+void Bench_DestroyScene(Bench::State& state)
+{
+	Scene* pScene = new Scene();
+	FillLevel(*pScene, state.entityCount);
+
+	state.Start();
+	delete pScene;
+	state.Stop(state.entityCount);
+}
+
+// ***********************************************************************
+
+void Bench_Assign(Bench::State& state)
+{
+	Scene scene;
+	eastl::vector<EntityID> ids(state.entityCount);
+	scene.NewEntities<CTransform>(state.entityCount, ids.data());
+
+	state.Start();
+	for (EntityID id : ids)
+		scene.Assign<CVelocity>(id);
+	state.Stop(ids.size());
+
+	state.residentBytes = scene.GetResidentBytes();
+}
+
+// ***********************************************************************
+
+void Bench_Remove(Bench::State& state)
+{
+	Scene scene;
+	eastl::vector<EntityID> ids(state.entityCount);
+	scene.NewEntities<CTransform, CVelocity>(state.entityCount, ids.data());
+
+	state.Start();
+	for (EntityID id : ids)
+		scene.Remove<CVelocity>(id);
+	state.Stop(ids.size());
+
+	state.residentBytes = scene.GetResidentBytes();
+}
+
+// ***********************************************************************
+
+void Bench_IterateOne(Bench::State& state)
+{
+	Scene scene;
+	scene.NewEntities<CTransform>(state.entityCount);
+
+	state.Start();
+	for (EntityID id : SceneIterator<CTransform>(scene))
+		scene.Get<CTransform>(id)->localPos.x += 1.0f;
+	state.Stop(state.entityCount);
+
+	state.residentBytes = scene.GetResidentBytes();
+}
+
+// ***********************************************************************
+
+// Half the entities have an extra component, so the query spans two archetypes
+void Bench_IterateTwo(Bench::State& state)
+{
+	Scene scene;
+	scene.NewEntities<CTransform, CVelocity>(state.entityCount / 2);
+	scene.NewEntities<CTransform, CVelocity, CVisibility>(state.entityCount - state.entityCount / 2);
+
+	state.Start();
+	for (EntityID id : SceneIterator<CTransform, CVelocity>(scene))
+		scene.Get<CTransform>(id)->localPos += scene.Get<CVelocity>(id)->velocity;
+	state.Stop(state.entityCount);
+
+	state.residentBytes = scene.GetResidentBytes();
+}
+
+// ***********************************************************************
+
+void Bench_IterateOneChunked(Bench::State& state)
+{
+	Scene scene;
+	scene.NewEntities<CTransform>(state.entityCount);
+
+	state.Start();
+	for (SceneChunk chunk : SceneChunkIterator<CTransform>(scene))
+	{
+		CTransform* pTransforms = chunk.Get<CTransform>();
+		for (uint32_t i = 0; i < chunk.Count(); i++)
+			pTransforms[i].localPos.x += 1.0f;
+	}
+	state.Stop(state.entityCount);
+
+	state.residentBytes = scene.GetResidentBytes();
+}
+
+// ***********************************************************************
+
+void Bench_IterateTwoChunked(Bench::State& state)
+{
+	Scene scene;
+	scene.NewEntities<CTransform, CVelocity>(state.entityCount / 2);
+	scene.NewEntities<CTransform, CVelocity, CVisibility>(state.entityCount - state.entityCount / 2);
+
+	state.Start();
+	for (SceneChunk chunk : SceneChunkIterator<CTransform, CVelocity>(scene))
+	{
+		CTransform* pTransforms = chunk.Get<CTransform>();
+		const CVelocity* pVelocities = chunk.Read<CVelocity>();
+		for (uint32_t i = 0; i < chunk.Count(); i++)
+			pTransforms[i].localPos += pVelocities[i].velocity;
+	}
+	state.Stop(state.entityCount);
+
+	state.residentBytes = scene.GetResidentBytes();
+}
+
+// ***********************************************************************
+
+// No parents or children, every transform has moved
+void Bench_TransformFlat(Bench::State& state)
+{
+	Scene scene;
+	scene.NewEntities<CTransform>(state.entityCount);
+	TransformHeirarchy(scene, 0.016f);
+	MoveRoots(scene);
+
+	state.Start();
+	TransformHeirarchy(scene, 0.016f);
+	state.Stop(state.entityCount);
+
+	state.residentBytes = scene.GetResidentBytes();
+}
+
+// ***********************************************************************
+
+// Chains of HIERARCHY_DEPTH transforms, and every root has moved so they all need updating
+void Bench_TransformDeep(Bench::State& state)
+{
+	Scene scene;
+	eastl::vector<EntityID> ids(state.entityCount);
+	scene.NewEntities<CTransform>(state.entityCount, ids.data());
+	for (int i = 0; i < state.entityCount; i++)
+	{
+		if (i % HIERARCHY_DEPTH != 0)
+			scene.SetParent(ids[i], ids[i - 1]);
+	}
+
+	// The first update sorts the hierarchy, which isn't what we're measuring here
+	TransformHeirarchy(scene, 0.016f);
+	MoveRoots(scene);
+
+	state.Start();
+	TransformHeirarchy(scene, 0.016f);
+	state.Stop(state.entityCount);
+
+	state.residentBytes = scene.GetResidentBytes();
+}
+
+// ***********************************************************************
+
+// Every entity has its own name, each is looked up once
+void Bench_FindEntity(Bench::State& state)
+{
+	Scene scene;
+	eastl::vector<eastl::string> names(state.entityCount);
+	for (int i = 0; i < state.entityCount; i++)
+	{
+		names[i].sprintf("Entity %i", i);
+		scene.Assign<CTransform>(scene.NewEntity(names[i].c_str()));
+	}
+
+	// The first lookup builds the index, which isn't what we're measuring here
+	scene.FindEntity(names[0].c_str());
+
+	state.Start();
+	int nFound = 0;
+	for (const eastl::string& name : names)
+	{
+		if (scene.FindEntity(name.c_str()).IsValid())
+			nFound++;
+	}
+	state.Stop(names.size());
+
+	ASSERT(nFound == state.entityCount, "Couldn't find every entity by name");
+	state.residentBytes = scene.GetResidentBytes();
+}
+
+// ***********************************************************************
+
+void Bench_SerializeBinary(Bench::State& state)
+{
+	Scene scene;
+	FillLevel(scene, state.entityCount);
+
+	state.Start();
+	eastl::string data = SceneSerializer::ToBinary(scene);
+	Scene* pLoaded = SceneSerializer::NewSceneFromBinary(data);
+	state.Stop(state.entityCount);
+
+	ASSERT(pLoaded && pLoaded->nActiveEntities == scene.nActiveEntities, "Binary round trip lost entities");
+	state.residentBytes = scene.GetResidentBytes();
+	delete pLoaded;
+}
+
+// ***********************************************************************
+
+void Bench_SerializeJson(Bench::State& state)
+{
+	Scene scene;
+	FillLevel(scene, state.entityCount);
+
+	state.Start();
+	eastl::string text = SerializeJsonValue(SceneSerializer::ToJson(scene));
+	Scene* pLoaded = SceneSerializer::NewSceneFromJson(ParseJsonFile(text));
+	state.Stop(state.entityCount);
+
+	ASSERT(pLoaded && pLoaded->nActiveEntities == scene.nActiveEntities, "Json round trip lost entities");
+	state.residentBytes = scene.GetResidentBytes();
+	delete pLoaded;
+}
+
+// ***********************************************************************
+
+void RegisterSceneBenchmarks()
+{
+	Bench::Register("EntityChurn", Bench_EntityChurn);
+	Bench::Register("NewEntities", Bench_NewEntities);
+	Bench::Register("DestroyEntities", Bench_DestroyEntities);
+	Bench::Register("DestroyScene", Bench_DestroyScene);
+	Bench::Register("Assign", Bench_Assign);
+	Bench::Register("Remove", Bench_Remove);
+	Bench::Register("IterateOne", Bench_IterateOne);
+	Bench::Register("IterateTwo", Bench_IterateTwo);
+	Bench::Register("IterateOneChunked", Bench_IterateOneChunked);
+	Bench::Register("IterateTwoChunked", Bench_IterateTwoChunked);
+	Bench::Register("TransformFlat", Bench_TransformFlat);
+	Bench::Register("TransformDeep", Bench_TransformDeep);
+	Bench::Register("FindEntity", Bench_FindEntity);
+	Bench::Register("SerializeBinary", Bench_SerializeBinary);
+	Bench::Register("SerializeJson", Bench_SerializeJson);
+}
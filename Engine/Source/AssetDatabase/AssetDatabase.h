@@ -48,14 +48,14 @@ struct Asset
 
 namespace AssetDB
 {
+    Asset* GetAssetRaw(AssetHandle handle);
+
     template<typename T>
     T* GetAsset(AssetHandle handle)
     {
         return static_cast<T*>(GetAssetRaw(handle));
     }
 
-    Asset* GetAssetRaw(AssetHandle handle);
-
     eastl::string GetAssetIdentifier(AssetHandle handle);
 
     void FreeAsset(AssetHandle handle);
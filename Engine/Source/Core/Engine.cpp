@@ -11,6 +11,7 @@
 #include "Editor/Editor.h"
 #include "Log.h"
 #include "Profiler.h"
+#include "Jobs.h"
 #include "Memory.h"
 #include "Maths.h"
 #include "Matrix.h"
@@ -158,6 +159,8 @@ void Engine::Initialize(const EngineConfig& _config)
 
 	Log::SetLogLevel(Log::EDebug);
 
+	Jobs::Initialize();
+
 	Vec2f ideal = GameRenderer::GetIdealFrameSize(AppWindow::GetWidth(), AppWindow::GetHeight());
 	GameRenderer::Initialize(ideal.x, ideal.y, config.postProcessing);
 	AudioDevice::Initialize();
@@ -284,6 +287,7 @@ void Engine::Run(World* pInitialWorld)
 	Editor::Destroy();
 	GfxDevice::Destroy();
 	AppWindow::Destroy();
+	Jobs::Destroy();
 
 	SDL_Quit();
 }
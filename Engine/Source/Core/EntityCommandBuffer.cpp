@@ -0,0 +1,298 @@
+#include "EntityCommandBuffer.h"
+
+#include <EASTL/sort.h>
+
+namespace
+{
+    const size_t COMMAND_DATA_BLOCK_SIZE = 16 * 1024;
+}
+
+// ***********************************************************************
+
+EntityCommandBuffer::EntityCommandBuffer(Scene& scene)
+{
+    pScene = &scene;
+}
+
+// ***********************************************************************
+
+EntityCommandBuffer::~EntityCommandBuffer()
+{
+    for (Command& command : commands)
+    {
+        DestroyStaged(command);
+    }
+    for (char* pBlock : dataBlocks)
+    {
+        delete[] pBlock;
+    }
+}
+
+// ***********************************************************************
+
+EntityID EntityCommandBuffer::NewEntity(const char* name)
+{
+    SDL_AtomicLock(&lock);
+    EntityID id = EntityID::New(EntityIndex(pendingEntities.size()), PENDING_ENTITY_VERSION);
+    PendingEntity pending;
+    pending.hasName = name != nullptr;
+    if (pending.hasName)
+        pending.name = name;
+    pendingEntities.push_back(pending);
+    SDL_AtomicUnlock(&lock);
+    return id;
+}
+
+// ***********************************************************************
+
+void EntityCommandBuffer::DestroyEntity(EntityID id)
+{
+    SDL_AtomicLock(&lock);
+    Record(id, CommandType::Destroy, 0, nullptr, nullptr);
+    SDL_AtomicUnlock(&lock);
+}
+
+// ***********************************************************************
+
+void EntityCommandBuffer::Playback()
+{
+    Scene& scene = *pScene;
+
+    // Reactive systems can record into this buffer while we play it back, so take what's here now,
+    // and anything recorded from here on is left for the next playback
+    SDL_AtomicLock(&lock);
+    commands.swap(playbackCommands);
+    pendingEntities.swap(playbackEntities);
+    SDL_AtomicUnlock(&lock);
+
+    // Make the pending entities first, so everything else can refer to them by their real ids
+    eastl::vector<EntityID> created;
+    created.reserve(playbackEntities.size());
+    for (const PendingEntity& pending : playbackEntities)
+    {
+        created.push_back(scene.NewEntity(pending.hasName ? pending.name.c_str() : nullptr));
+    }
+    for (Command& command : playbackCommands)
+    {
+        if (command.id.Version() == PENDING_ENTITY_VERSION)
+            command.id = created[command.id.Index()];
+    }
+
+    // Group commands by entity, in the order the entities are stored, keeping the recorded order within each entity
+    eastl::sort(playbackCommands.begin(), playbackCommands.end(), [](const Command& a, const Command& b) {
+        if (a.id.value != b.id.value)
+            return a.id.value < b.id.value;
+        return a.sequence < b.sequence;
+    });
+
+    // Work out what will happen to each entity overall, so they only have to move once
+    for (size_t i = 0; i < playbackCommands.size();)
+    {
+        EntityID id = playbackCommands[i].id;
+        size_t end = i;
+        while (end < playbackCommands.size() && playbackCommands[end].id == id)
+            end++;
+
+        bool alive = id.IsValid() && id.Index() < scene.entities.size() && scene.entities[id.Index()].id == id;
+        ComponentMask mask = alive ? scene.entities[id.Index()].pArchetype->mask : ComponentMask();
+
+        EntityChange change{ id, false, ComponentMask(), ComponentMask(), uint32_t(staged.size()), 0 };
+        for (size_t j = i; j < end; j++)
+        {
+            Command& command = playbackCommands[j];
+            if (!alive || change.destroy)
+            {
+                DestroyStaged(command);
+                continue;
+            }
+
+            // An earlier staged component of the same type is replaced, or cancelled out by a remove
+            if (command.type != CommandType::Destroy && change.added.test(command.componentId))
+            {
+                for (size_t k = change.firstStaged; k < staged.size(); k++)
+                {
+                    if (staged[k]->componentId == command.componentId)
+                    {
+                        DestroyStaged(*staged[k]);
+                        staged.erase(staged.begin() + k);
+                        break;
+                    }
+                }
+                change.added.reset(command.componentId);
+                if (command.type == CommandType::Remove)
+                    continue;
+            }
+
+            switch (command.type)
+            {
+            case CommandType::Destroy:
+                for (size_t k = change.firstStaged; k < staged.size(); k++)
+                {
+                    DestroyStaged(*staged[k]);
+                }
+                staged.resize(change.firstStaged);
+                change.destroy = true;
+                break;
+            case CommandType::Assign:
+                ASSERT(!mask.test(command.componentId) || change.removed.test(command.componentId), "You're trying to assign a component to an entity that already has this component");
+                scene.GetOrCreateComponentPool(*command.pTypeData); // Needs to exist before we make archetypes with it
+                change.added.set(command.componentId);
+                staged.push_back(&command);
+                break;
+            case CommandType::Remove:
+                ASSERT(mask.test(command.componentId) && !change.removed.test(command.componentId), "The component you're trying to remove is not assigned to this entity");
+                change.removed.set(command.componentId);
+                break;
+            default:
+                break;
+            }
+        }
+        change.nStaged = uint32_t(staged.size()) - change.firstStaged;
+
+        if (alive)
+            changes.push_back(change);
+        i = end;
+    }
+
+    // Tell the reactive systems about removals while the components still exist, one component type at a time
+    for (ComponentPool* pPool : scene.componentPools)
+    {
+        if (pPool == nullptr || !pPool->ReactsToRemove())
+            continue;
+
+        uint32_t componentId = pPool->componentId;
+        for (const EntityChange& change : changes)
+        {
+            const Scene::EntityDesc& desc = scene.entities[change.id.Index()];
+            if (desc.id != change.id || !desc.pArchetype->mask.test(componentId))
+                continue;
+
+            if (change.destroy || change.removed.test(componentId))
+                pPool->OnRemoved(scene, change.id);
+        }
+    }
+
+    // Now the structural changes, each entity moves straight to its final archetype
+    for (const EntityChange& change : changes)
+    {
+        // Reactive systems may have destroyed it in the meantime
+        if (scene.entities[change.id.Index()].id != change.id)
+        {
+            for (uint32_t k = 0; k < change.nStaged; k++)
+            {
+                DestroyStaged(*staged[change.firstStaged + k]);
+            }
+            continue;
+        }
+
+        if (change.destroy)
+        {
+            scene.ReleaseEntity(change.id);
+            continue;
+        }
+
+        Scene::EntityDesc& desc = scene.entities[change.id.Index()];
+        ComponentMask oldMask = desc.pArchetype->mask;
+        ComponentMask newMask = (oldMask & ~change.removed) | change.added;
+        if (newMask != oldMask)
+            scene.MoveEntity(change.id.Index(), scene.GetOrCreateArchetype(newMask));
+
+        for (uint32_t k = 0; k < change.nStaged; k++)
+        {
+            Command& command = *staged[change.firstStaged + k];
+            ComponentPool* pPool = scene.componentPools[command.componentId];
+            void* pComponent = scene.GetRaw(change.id.Index(), command.componentId);
+
+            // Removed then assigned again, so the old one is still here
+            if (oldMask.test(command.componentId))
+            {
+                pPool->pDestructor(pComponent, pPool->pTypeData);
+                Archetype* pArchetype = desc.pArchetype;
+                pArchetype->MarkChanged(pArchetype->chunks[desc.chunk], pArchetype->GetColumn(command.componentId));
+            }
+
+            pPool->pMove(pComponent, command.pData, pPool->pTypeData);
+            command.pData = nullptr;
+        }
+
+        ComponentMask changedMask = oldMask ^ newMask;
+        for (uint32_t componentId = uint32_t(changedMask.find_first()); componentId < MAX_COMPONENTS; componentId = uint32_t(changedMask.find_next(componentId)))
+        {
+            if (newMask.test(componentId))
+                scene.componentPools[componentId]->nEntities++;
+            else
+                scene.componentPools[componentId]->nEntities--;
+        }
+    }
+
+    // And finally the additions, again one component type at a time
+    for (ComponentPool* pPool : scene.componentPools)
+    {
+        if (pPool == nullptr || !pPool->ReactsToAdd())
+            continue;
+
+        uint32_t componentId = pPool->componentId;
+        for (const EntityChange& change : changes)
+        {
+            const Scene::EntityDesc& desc = scene.entities[change.id.Index()];
+            if (desc.id != change.id || !change.added.test(componentId) || !desc.pArchetype->mask.test(componentId))
+                continue;
+
+            pPool->OnAdded(scene, change.id);
+        }
+    }
+
+    playbackCommands.clear();
+    playbackEntities.clear();
+    changes.clear();
+    staged.clear();
+
+    // Components staged during playback sit after ours in the data blocks, so they can only be reused once nothing is waiting
+    if (commands.empty())
+    {
+        currentBlock = 0;
+        blockOffset = 0;
+    }
+}
+
+// ***********************************************************************
+
+void EntityCommandBuffer::Record(EntityID id, CommandType type, uint32_t componentId, TypeData* pTypeData, void* pData)
+{
+    commands.push_back(Command{ id, uint32_t(commands.size()), type, componentId, pTypeData, pData });
+}
+
+// ***********************************************************************
+
+void* EntityCommandBuffer::AllocateData(size_t size, size_t alignment)
+{
+    ASSERT(size + alignment <= COMMAND_DATA_BLOCK_SIZE, "Component is too big to be staged in a command buffer");
+
+    while (true)
+    {
+        if (currentBlock == dataBlocks.size())
+            dataBlocks.push_back(new char[COMMAND_DATA_BLOCK_SIZE]);
+
+        uintptr_t blockStart = reinterpret_cast<uintptr_t>(dataBlocks[currentBlock]);
+        uintptr_t address = (blockStart + blockOffset + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        if (address + size <= blockStart + COMMAND_DATA_BLOCK_SIZE)
+        {
+            blockOffset = address + size - blockStart;
+            return reinterpret_cast<void*>(address);
+        }
+
+        currentBlock++;
+        blockOffset = 0;
+    }
+}
+
+// ***********************************************************************
+
+void EntityCommandBuffer::DestroyStaged(Command& command)
+{
+    if (command.pData)
+    {
+        command.pTypeData->pTypeOps->Destruct(command.pData);
+        command.pData = nullptr;
+    }
+}
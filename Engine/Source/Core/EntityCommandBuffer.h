@@ -0,0 +1,142 @@
+#pragma once
+
+#include "Scene.h"
+
+#include <EASTL/vector.h>
+#include <EASTL/string.h>
+
+/* EXAMPLE USAGE
+/ **************
+
+// Structural changes can't be made to a scene while iterating it, or from systems running
+// in parallel, so record them into a command buffer instead
+
+EntityCommandBuffer commands(scene);
+for (EntityID ent : SceneIterator<CHealth>(scene))
+{
+	if (scene.Get<CHealth>(ent)->health <= 0)
+	{
+		commands.DestroyEntity(ent);
+
+		EntityID explosion = commands.NewEntity("Explosion");
+		commands.Assign<CTransform>(explosion)->localPos = ...;
+	}
+}
+
+// Then apply them all in one go once nothing is iterating the scene
+commands.Playback();
+
+*/
+
+// Entities made by a command buffer have this version until playback,
+// those ids can only be used with the same command buffer
+const uint32_t PENDING_ENTITY_VERSION = 0xffffffff;
+
+// Records entity creation, destruction and component changes to apply to a scene later
+// Recording is thread safe, so one buffer can be shared by parallel systems
+// On playback all of an entity's changes are applied with a single move between archetypes,
+// and reactive callbacks fire grouped by component type rather than one change at a time
+struct EntityCommandBuffer
+{
+	EntityCommandBuffer(Scene& scene);
+	~EntityCommandBuffer();
+
+	// Returns a pending id, the entity is really made on playback
+	// Like Scene::NewEntity, it's only given a CName if it's given a name
+	EntityID NewEntity(const char* name = nullptr);
+
+	void DestroyEntity(EntityID id);
+
+	// The returned component is copied into the scene on playback, so fill it in before then
+	template <typename T>
+	T* Assign(EntityID id);
+
+	template <typename T>
+	void Remove(EntityID id);
+
+	// Applies everything recorded, then clears the buffer so it can be reused
+	// Anything recorded during playback, say by reactive systems, is kept for the next playback
+	void Playback();
+
+	enum class CommandType
+	{
+		Destroy,
+		Assign,
+		Remove
+	};
+
+	struct Command
+	{
+		EntityID id;
+		uint32_t sequence;
+		CommandType type;
+		uint32_t componentId;
+		TypeData* pTypeData;
+		void* pData; // Staged component for Assign commands
+	};
+
+	// Everything that will happen to one entity during playback
+	struct EntityChange
+	{
+		EntityID id;
+		bool destroy;
+		ComponentMask added;
+		ComponentMask removed;
+		uint32_t firstStaged;
+		uint32_t nStaged;
+	};
+
+	// An entity to make at the start of playback
+	struct PendingEntity
+	{
+		eastl::string name;
+		bool hasName;
+	};
+
+	Scene* pScene{ nullptr };
+
+	eastl::vector<Command> commands;
+	eastl::vector<PendingEntity> pendingEntities;
+
+	// Staged component data, blocks are kept for reuse after playback
+	eastl::vector<char*> dataBlocks;
+	size_t currentBlock{ 0 };
+	size_t blockOffset{ 0 };
+
+	// Playback working memory, the commands being played back are swapped out of the ones above
+	eastl::vector<Command> playbackCommands;
+	eastl::vector<PendingEntity> playbackEntities;
+	eastl::vector<EntityChange> changes;
+	eastl::vector<Command*> staged;
+
+	SDL_SpinLock lock{ 0 };
+
+private:
+	void Record(EntityID id, CommandType type, uint32_t componentId, TypeData* pTypeData, void* pData);
+	void* AllocateData(size_t size, size_t alignment);
+	void DestroyStaged(Command& command);
+};
+
+// -----------------------------------
+// ------------INTERNAL---------------
+// -----------------------------------
+
+template <typename T>
+T* EntityCommandBuffer::Assign(EntityID id)
+{
+	SDL_AtomicLock(&lock);
+	T* pComponent = new (AllocateData(sizeof(T), alignof(T))) T();
+	Record(id, CommandType::Assign, Component::Index<T>(), &TypeDatabase::Get<T>(), pComponent);
+	SDL_AtomicUnlock(&lock);
+	return pComponent;
+}
+
+// ***********************************************************************
+
+template <typename T>
+void EntityCommandBuffer::Remove(EntityID id)
+{
+	SDL_AtomicLock(&lock);
+	Record(id, CommandType::Remove, Component::Index<T>(), &TypeDatabase::Get<T>(), nullptr);
+	SDL_AtomicUnlock(&lock);
+}
@@ -0,0 +1,145 @@
+#include "Jobs.h"
+
+#include "ErrorHandling.h"
+#include "Log.h"
+
+#include <SDL_thread.h>
+#include <SDL_mutex.h>
+#include <SDL_cpuinfo.h>
+#include <EASTL/deque.h>
+#include <EASTL/vector.h>
+
+namespace
+{
+	struct Job
+	{
+		Jobs::JobFunc func;
+		void* pData;
+		Jobs::Counter* pCounter;
+	};
+
+	SDL_mutex* pQueueMutex{ nullptr };
+	SDL_cond* pQueueCondition{ nullptr }; // Signalled when a job is queued or a counter reaches zero
+	eastl::deque<Job> queue;
+	eastl::vector<SDL_Thread*> workers;
+	bool running{ false };
+
+	// Expects the queue mutex to be held, and releases it while the job runs
+	void RunJob(const Job& job)
+	{
+		SDL_UnlockMutex(pQueueMutex);
+		job.func(job.pData);
+
+		// Take the lock before waking anyone, so a waiter can't miss this between checking the counter and sleeping
+		int previous = SDL_AtomicAdd(&job.pCounter->value, -1);
+		SDL_LockMutex(pQueueMutex);
+		if (previous == 1)
+			SDL_CondBroadcast(pQueueCondition);
+	}
+
+	int WorkerMain(void* pData)
+	{
+		SDL_LockMutex(pQueueMutex);
+		while (running)
+		{
+			if (queue.empty())
+			{
+				SDL_CondWait(pQueueCondition, pQueueMutex);
+				continue;
+			}
+			Job job = queue.front();
+			queue.pop_front();
+			RunJob(job);
+		}
+		SDL_UnlockMutex(pQueueMutex);
+		return 0;
+	}
+}
+
+// ***********************************************************************
+
+void Jobs::Initialize()
+{
+	ASSERT(pQueueMutex == nullptr, "Job system is already initialized");
+
+	pQueueMutex = SDL_CreateMutex();
+	pQueueCondition = SDL_CreateCond();
+	running = true;
+
+	int nWorkers = SDL_GetCPUCount() - 1;
+	for (int i = 0; i < nWorkers; i++)
+	{
+		workers.push_back(SDL_CreateThread(WorkerMain, "JobWorker", nullptr));
+	}
+	Log::Info("Job system started with %i workers", nWorkers);
+}
+
+// ***********************************************************************
+
+void Jobs::Destroy()
+{
+	SDL_LockMutex(pQueueMutex);
+	running = false;
+	SDL_CondBroadcast(pQueueCondition);
+	SDL_UnlockMutex(pQueueMutex);
+
+	for (SDL_Thread* pThread : workers)
+	{
+		SDL_WaitThread(pThread, nullptr);
+	}
+	workers.clear();
+	queue.clear();
+
+	SDL_DestroyCond(pQueueCondition);
+	SDL_DestroyMutex(pQueueMutex);
+	pQueueCondition = nullptr;
+	pQueueMutex = nullptr;
+}
+
+// ***********************************************************************
+
+int Jobs::GetWorkerCount()
+{
+	return (int)workers.size();
+}
+
+// ***********************************************************************
+
+void Jobs::Run(JobFunc func, void* pData, Counter* pCounter)
+{
+	// No pool, so just do the work now
+	if (pQueueMutex == nullptr)
+	{
+		func(pData);
+		return;
+	}
+
+	SDL_AtomicAdd(&pCounter->value, 1);
+
+	SDL_LockMutex(pQueueMutex);
+	queue.push_back(Job{ func, pData, pCounter });
+	SDL_CondBroadcast(pQueueCondition);
+	SDL_UnlockMutex(pQueueMutex);
+}
+
+// ***********************************************************************
+
+void Jobs::Wait(Counter* pCounter)
+{
+	if (pQueueMutex == nullptr)
+		return;
+
+	SDL_LockMutex(pQueueMutex);
+	while (SDL_AtomicGet(&pCounter->value) > 0)
+	{
+		if (queue.empty())
+		{
+			SDL_CondWait(pQueueCondition, pQueueMutex);
+			continue;
+		}
+		Job job = queue.front();
+		queue.pop_front();
+		RunJob(job);
+	}
+	SDL_UnlockMutex(pQueueMutex);
+}
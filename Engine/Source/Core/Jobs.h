@@ -0,0 +1,30 @@
+#pragma once
+
+#include <SDL_atomic.h>
+
+// A small pool of worker threads for running engine work in parallel
+// Jobs are plain function pointers with a data pointer, and are grouped with a Counter
+// that you can wait on. Waiting threads help out by running queued jobs themselves,
+// so this all still works (just serially) if the pool was never initialized
+namespace Jobs
+{
+	typedef void (*JobFunc)(void* pData);
+
+	// Number of jobs in flight for some piece of work, zero once it's all done
+	struct Counter
+	{
+		SDL_atomic_t value{ 0 };
+	};
+
+	// Starts one worker per core, minus one for the calling thread
+	void Initialize();
+	void Destroy();
+
+	int GetWorkerCount();
+
+	// Queues a job to run on any thread, jobs start in the order they were queued
+	void Run(JobFunc func, void* pData, Counter* pCounter);
+
+	// Returns once the counter reaches zero, running queued jobs on this thread in the meantime
+	void Wait(Counter* pCounter);
+}
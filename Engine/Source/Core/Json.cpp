@@ -470,7 +470,7 @@ JsonValue& JsonValue::operator=(JsonValue&& copy)
 
 // ***********************************************************************
 
-JsonValue::JsonValue(eastl::vector<JsonValue>& array)
+JsonValue::JsonValue(const eastl::vector<JsonValue>& array)
 {
     internalData.pArray = nullptr;
     internalData.pArray = new eastl::vector<JsonValue>(array.begin(), array.end());
@@ -479,7 +479,7 @@ JsonValue::JsonValue(eastl::vector<JsonValue>& array)
 
 // ***********************************************************************
 
-JsonValue::JsonValue(eastl::map<eastl::string, JsonValue>& object)
+JsonValue::JsonValue(const eastl::map<eastl::string, JsonValue>& object)
 {
     internalData.pArray = nullptr;
     internalData.pObject = new eastl::map<eastl::string, JsonValue>(object.begin(), object.end());
@@ -35,8 +35,8 @@ struct JsonValue
 	JsonValue& operator=(const JsonValue& copy);
 	JsonValue& operator=(JsonValue&& copy);
 
-	JsonValue(eastl::vector<JsonValue>& array);
-	JsonValue(eastl::map<eastl::string, JsonValue>& object);
+	JsonValue(const eastl::vector<JsonValue>& array);
+	JsonValue(const eastl::map<eastl::string, JsonValue>& object);
 	JsonValue(eastl::string string);
 	JsonValue(const char* string);
 	JsonValue(double number);
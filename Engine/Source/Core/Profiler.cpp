@@ -1,10 +1,12 @@
 #include "Profiler.h"
 
 #include <SDL_timer.h>
+#include <SDL_atomic.h>
 
 namespace {
   Profiler::ScopeData singleFrameData[100]; // cleared at the end of every frame
   int inUseSlots = 0;
+  SDL_SpinLock frameDataLock = 0; // Scene systems may be profiled from job worker threads
 }
 
 // ***********************************************************************
@@ -18,9 +20,14 @@ void Profiler::ClearFrameData()
 
 void Profiler::PushProfile(const char* name, double time)
 {
-  singleFrameData[inUseSlots].name = name;
-  singleFrameData[inUseSlots].time = time;
-  inUseSlots++;
+  SDL_AtomicLock(&frameDataLock);
+  if (inUseSlots < 100)
+  {
+    singleFrameData[inUseSlots].name = name;
+    singleFrameData[inUseSlots].time = time;
+    inUseSlots++;
+  }
+  SDL_AtomicUnlock(&frameDataLock);
 }
 
 // ***********************************************************************
@@ -1,5 +1,14 @@
 #include "Scene.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <EASTL/sort.h>
+#include <EASTL/algorithm.h>
+#include <SDL_timer.h>
+
+// Type index -> component index, see Component::Index
 eastl::map<uint32_t, uint32_t> s_componentTypeIdMap;
+SDL_SpinLock s_componentTypeIdLock{ 0 };
 
 REFLECT_COMPONENT_BEGIN(CName)
 REFLECT_MEMBER(name)
@@ -28,26 +37,32 @@ REFLECT_END()
 
 // ***********************************************************************
 
-void RecursiveTransformTree(Scene& scene, EntityID root)
+namespace
 {
-    CTransform* pParentTrans = scene.Get<CTransform>(root);
-    CParent* pParent = scene.Get<CParent>(root);
-			
-	EntityID currChild = pParent->firstChild;
-	for(int i = 0; i < pParent->nChildren; i++)
-	{
-        if (!scene.Has<CTransform>(currChild))
-            continue;
-
-        CTransform* pChildTrans = scene.Get<CTransform>(currChild);
-
-        Matrixf childMat = Matrixf::MakeTRS(pChildTrans->localPos, pChildTrans->localRot, pChildTrans->localSca);
-        pChildTrans->globalTransform = pParentTrans->globalTransform * childMat;
-
-        if (scene.Has<CParent>(currChild))
-            RecursiveTransformTree(scene, currChild);
+    // True if an entity going from oldMask to newMask joins, leaves or changes shape in a transform hierarchy
+    bool IsHierarchyChange(const ComponentMask& oldMask, const ComponentMask& newMask)
+    {
+        ComponentMask hierarchyMask;
+        hierarchyMask.set(Component::Index<CParent>());
+        hierarchyMask.set(Component::Index<CChild>());
+
+        ComponentMask changed = oldMask ^ newMask;
+        if (MaskIntersects(changed, hierarchyMask))
+            return true;
+        return changed.test(Component::Index<CTransform>()) && (MaskIntersects(oldMask, hierarchyMask) || MaskIntersects(newMask, hierarchyMask));
+    }
 
-		currChild = scene.Get<CChild>(currChild)->next;
+    // Returns true if the local transform has changed since globalTransform was last built, and remembers it
+    bool ConsumeLocalChange(CTransform& trans)
+    {
+        if (trans.built && trans.builtPos == trans.localPos && trans.builtRot == trans.localRot && trans.builtSca == trans.localSca)
+            return false;
+
+        trans.builtPos = trans.localPos;
+        trans.builtRot = trans.localRot;
+        trans.builtSca = trans.localSca;
+        trans.built = true;
+        return true;
     }
 }
 
@@ -55,49 +70,279 @@ void RecursiveTransformTree(Scene& scene, EntityID root)
 
 void TransformHeirarchy(Scene& scene, float deltaTime)
 {
-    // Phase 1 would be transforming all the parent transforms. We'll take their transform components and build a renderMatrix
-    // Not doing this as we don't store the render matrix
-    eastl::vector<EntityID> roots;
-
-    for (EntityID ent : SceneIterator<CTransform>(scene))
+    // Entities that aren't part of any hierarchy just need their own matrix, and only when they've moved
+    // Chunks nobody has written to since last time are skipped entirely
+    for (SceneChunk chunk : SceneChunkIterator<Changed<CTransform>, Without<CParent, CChild>>(scene, scene.transformsVersion))
     {   
-        // We only want root entities here, so ignoring children, they'll come later
-        if (!scene.Has<CChild>(ent))
+        // Fetched raw so that only chunks we actually update are marked as changed
+        CTransform* pTransforms = chunk.pArchetype->GetArray<CTransform>(chunk.pChunk);
+        bool anyUpdated = false;
+        for (uint32_t i = 0; i < chunk.Count(); i++)
         {
-            CTransform* pTrans = scene.Get<CTransform>(ent);
-            pTrans->globalTransform = Matrixf::MakeTRS(pTrans->localPos, pTrans->localRot, pTrans->localSca);
-
-            if (scene.Has<CParent>(ent)) // If this entity is the top of a tree, we need to recurse it's children
-                roots.push_back(ent);
+            CTransform& trans = pTransforms[i];
+            if (ConsumeLocalChange(trans))
+            {
+                trans.globalTransform = Matrixf::MakeTRS(trans.localPos, trans.localRot, trans.localSca);
+                anyUpdated = true;
+            }
         }
+        if (anyUpdated)
+            chunk.MarkChanged<CTransform>();
+    }
+
+    // Everything rebuilds after the hierarchy changes shape, as entities may have new parents
+    bool forceUpdate = scene.hierarchyChanged;
+    if (scene.hierarchyChanged)
+        scene.RebuildTransformHierarchy();
+
+    // Then the hierarchies in one pass, parents are always done before their children
+    // A changed transform changes the whole subtree below it, unchanged subtrees are skipped
+    for (Scene::HierarchyNode& node : scene.transformHierarchy)
+    {
+        node.pTransform = static_cast<CTransform*>(scene.GetRaw(node.id.Index(), Component::Index<CTransform>()));
+        CTransform& trans = *node.pTransform;
+
+        node.changed = ConsumeLocalChange(trans) || forceUpdate;
+        if (node.parent >= 0)
+            node.changed |= scene.transformHierarchy[node.parent].changed;
+
+        if (!node.changed)
+            continue;
+
+        trans.globalTransform = Matrixf::MakeTRS(trans.localPos, trans.localRot, trans.localSca);
+        if (node.parent >= 0)
+            trans.globalTransform = scene.transformHierarchy[node.parent].pTransform->globalTransform * trans.globalTransform;
+        scene.MarkChanged<CTransform>(node.id);
     }
 
-    // Phase 2, run through each roots graph updating all their children
-    for (EntityID root : roots)
+    // Our own changes are stamped with the version we're leaving behind, so they won't be picked up next time
+    scene.transformsVersion = scene.AdvanceChangeVersion();
+}
+
+// ***********************************************************************
+
+uint32_t Component::FromTypeIndex(uint32_t typeIndex)
+{
+    SDL_AtomicLock(&s_componentTypeIdLock);
+    eastl::map<uint32_t, uint32_t>::iterator it = s_componentTypeIdMap.find(typeIndex);
+    if (it == s_componentTypeIdMap.end())
     {
-        RecursiveTransformTree(scene, root);
+        ASSERT(s_componentTypeIdMap.size() < MAX_COMPONENTS, "Too many component types, raise ATHENA_MAX_COMPONENTS");
+        it = s_componentTypeIdMap.insert(eastl::make_pair(typeIndex, uint32_t(s_componentTypeIdMap.size()))).first;
     }
+    uint32_t componentIndex = it->second;
+    SDL_AtomicUnlock(&s_componentTypeIdLock);
+    return componentIndex;
 }
 
 // ***********************************************************************
 
-ComponentPool::ComponentPool(size_t elementsize, TypeData& typeData, void(*_pDestructor)(void*, TypeData*))
+ComponentPool::ComponentPool(uint32_t _componentId, size_t elementsize, TypeData& typeData, void(*_pDestructor)(void*, TypeData*), void(*_pMove)(void*, void*, TypeData*))
 {
+    componentId = _componentId;
     elementSize = elementsize;
-    pData = new char[elementSize * MAX_ENTITIES];
     pDestructor = _pDestructor;
+    pMove = _pMove;
     pTypeData = &typeData;
 }
 
 // ***********************************************************************
 
-ComponentPool::~ComponentPool()
+void ComponentPool::OnAdded(Scene& scene, EntityID id)
 {
+    for (ReactiveSystemFunc func : onAddedCallbacks)
+    {
+        func(scene, id);
+    }
+    if (!onAddedBatchCallbacks.empty())
+        pendingAdded.push_back(id);
+}
+
+// ***********************************************************************
+
+void ComponentPool::OnRemoved(Scene& scene, EntityID id)
+{
+    for (ReactiveSystemFunc func : onRemovedCallbacks)
+    {
+        func(scene, id);
+    }
+    if (!onRemovedBatchCallbacks.empty())
+        pendingRemoved.push_back(id);
+}
+
+// ***********************************************************************
+
+SnapshotColumn::SnapshotColumn(ComponentPool* _pPool, void* pSource, uint32_t _count)
+{
+    pPool = _pPool;
+    count = _count;
+    pData = new char[count * pPool->elementSize];
+
+    if (pPool->isTriviallyCopyable)
+    {
+        memcpy(pData, pSource, count * pPool->elementSize);
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        pPool->pTypeData->pTypeOps->PlacementNew(pData + i * pPool->elementSize);
+        pPool->pTypeData->pTypeOps->Copy(pData + i * pPool->elementSize, static_cast<char*>(pSource) + i * pPool->elementSize);
+    }
+}
+
+// ***********************************************************************
+
+SnapshotColumn::~SnapshotColumn()
+{
+    if (!pPool->isTriviallyCopyable)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            pPool->pDestructor(pData + i * pPool->elementSize, pPool->pTypeData);
+        }
+    }
     delete[] pData;
 }
 
 // ***********************************************************************
 
+void SnapshotColumn::CopyTo(void* pDestination) const
+{
+    if (pPool->isTriviallyCopyable)
+    {
+        memcpy(pDestination, pData, count * pPool->elementSize);
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        char* pComponent = static_cast<char*>(pDestination) + i * pPool->elementSize;
+        pPool->pTypeData->pTypeOps->PlacementNew(pComponent);
+        pPool->pTypeData->pTypeOps->Copy(pComponent, pData + i * pPool->elementSize);
+    }
+}
+
+// ***********************************************************************
+
+Archetype::Archetype(Scene& scene, const ComponentMask& _mask)
+{
+    pScene = &scene;
+    mask = _mask;
+
+    size_t bytesPerEntity = sizeof(EntityID);
+    for (uint32_t i = uint32_t(mask.find_first()); i < MAX_COMPONENTS; i = uint32_t(mask.find_next(i)))
+    {
+        ASSERT(i < scene.componentPools.size() && scene.componentPools[i] != nullptr, "Making an archetype for a component with no pool");
+        ComponentPool* pPool = scene.componentPools[i];
+        pPool->archetypes.push_back(this);
+        componentIds.push_back(i);
+        columnPools.push_back(pPool);
+        bytesPerEntity += pPool->elementSize;
+
+        if (columnLookup.size() <= i)
+            columnLookup.resize(i + 1, -1);
+        columnLookup[i] = int(componentIds.size() - 1);
+    }
+
+    // Leave room to align the start of every column to a cache line
+    size_t usableBytes = ARCHETYPE_CHUNK_SIZE - ARCHETYPE_CHUNK_ALIGNMENT * (componentIds.size() + 1);
+    chunkCapacity = uint32_t(usableBytes / bytesPerEntity);
+    ASSERT(chunkCapacity > 0, "Components are too large to fit in an archetype chunk");
+
+    // Entity ids come first in the chunk, then each component column
+    size_t offset = chunkCapacity * sizeof(EntityID);
+    for (ComponentPool* pPool : columnPools)
+    {
+        offset = (offset + ARCHETYPE_CHUNK_ALIGNMENT - 1) & ~(ARCHETYPE_CHUNK_ALIGNMENT - 1);
+        columnOffsets.push_back(offset);
+        offset += chunkCapacity * pPool->elementSize;
+    }
+    ASSERT(offset <= ARCHETYPE_CHUNK_SIZE, "Archetype chunk layout overflowed");
+}
+
+// ***********************************************************************
+
+Archetype::~Archetype()
+{
+    // The chunk memory itself belongs to the scene's arena, which frees it all at once
+    for (ArchetypeChunk* pChunk : chunks)
+    {
+        delete pChunk;
+    }
+}
+
+// ***********************************************************************
+
+void Archetype::FreeChunk(ArchetypeChunk* pChunk)
+{
+    for (ComponentPool* pPool : columnPools)
+    {
+        pPool->residentBytes -= chunkCapacity * pPool->elementSize;
+    }
+    pScene->FreeChunk(pChunk);
+}
+
+// ***********************************************************************
+
+void Archetype::AllocateRow(EntityID id, uint32_t& outChunk, uint32_t& outRow)
+{
+    AllocateRows(1, outChunk, outRow);
+    GetEntities(chunks[outChunk])[outRow] = id;
+}
+
+// ***********************************************************************
+
+ArchetypeChunk* Archetype::NewChunk()
+{
+    ArchetypeChunk* pChunk = pScene->AllocateChunk(componentIds.size());
+    chunks.push_back(pChunk);
+
+    for (ComponentPool* pPool : columnPools)
+    {
+        pPool->residentBytes += chunkCapacity * pPool->elementSize;
+    }
+    return pChunk;
+}
+
+// ***********************************************************************
+
+uint32_t Archetype::AllocateRows(uint32_t count, uint32_t& outChunk, uint32_t& outFirstRow)
+{
+    if (chunks.empty() || chunks.back()->count == chunkCapacity)
+        NewChunk();
+
+    ArchetypeChunk* pChunk = chunks.back();
+    uint32_t nRows = eastl::min(count, chunkCapacity - pChunk->count);
+    outChunk = uint32_t(chunks.size() - 1);
+    outFirstRow = pChunk->count;
+    pChunk->count += nRows;
+    nEntities += nRows;
+
+    // New rows count as changes to every column
+    for (size_t column = 0; column < pChunk->columnVersions.size(); column++)
+    {
+        pChunk->columnVersions[column] = pScene->changeVersion;
+        columnPools[column]->changeVersion = pScene->changeVersion;
+    }
+    return nRows;
+}
+
+// ***********************************************************************
+
+bool Archetype::ChangedSince(ArchetypeChunk* pChunk, const ComponentMask& componentMask, uint32_t version) const
+{
+    if (componentMask.none())
+        return true;
+
+    for (int column = 0; column < (int)componentIds.size(); column++)
+    {
+        if (componentMask.test(componentIds[column]) && pChunk->columnVersions[column] > version)
+            return true;
+    }
+    return false;
+}
+
+// ***********************************************************************
+
 Scene::Scene()
 {
     Engine::NewSceneCreated(*this);
@@ -107,9 +352,53 @@ Scene::Scene()
 
 Scene::~Scene()
 {
-    for (EntityDesc& desc : entities)
+    // Reactive systems still hear about every entity going away. They may destroy entities themselves,
+    // so each one is checked again before it's reported. Batched ones are flushed here rather than waiting for
+    // a next phase that never comes, first with whatever was already queued, so they see adds before removes
+    FlushReactiveEvents();
+    for (ComponentPool* pPool : componentPools)
     {
-        DestroyEntity(desc.id);
+        if (pPool == nullptr || !pPool->ReactsToRemove())
+            continue;
+
+        for (size_t i = 0; i < entities.size(); i++)
+        {
+            EntityID id = entities[i].id;
+            if (id.Index() == i && entities[i].pArchetype->mask.test(pPool->componentId))
+                pPool->OnRemoved(*this, id);
+        }
+    }
+    FlushReactiveEvents();
+
+    // No need to release entities one by one, only components with destructors need visiting,
+    // and all the chunk memory goes back in one go with the arena
+    for (Archetype* pArchetype : archetypes)
+    {
+        for (size_t column = 0; column < pArchetype->columnPools.size(); column++)
+        {
+            ComponentPool* pPool = pArchetype->columnPools[column];
+            if (pPool->isTriviallyCopyable)
+                continue;
+
+            for (ArchetypeChunk* pChunk : pArchetype->chunks)
+            {
+                for (uint32_t row = 0; row < pChunk->count; row++)
+                    pPool->pDestructor(pArchetype->GetComponent(pChunk, int(column), row), pPool->pTypeData);
+            }
+        }
+    }
+
+    for (SceneQuery* pQuery : queries)
+    {
+        delete pQuery;
+    }
+    for (Archetype* pArchetype : archetypes)
+    {
+        delete pArchetype;
+    }
+    for (ArchetypeChunk* pChunk : idleChunks)
+    {
+        delete pChunk;
     }
     for (ComponentPool* pPool : componentPools)
     {
@@ -121,49 +410,283 @@ Scene::~Scene()
 
 EntityID Scene::NewEntity(const char* name)
 {
-    nActiveEntities++;
+    EntityIndex newIndex;
     if (!freeEntities.empty())
     {
-        EntityIndex newIndex = freeEntities.back();
+        newIndex = freeEntities.back();
         freeEntities.pop_back();
         entities[newIndex].id = EntityID::New(newIndex, entities[newIndex].id.Version());
-        Assign<CName>(entities[newIndex].id)->name = name;
-        return entities[newIndex].id;
     }
-    entities.push_back({ EntityID::New(EntityIndex(entities.size()), 0), ComponentMask() });
-    Assign<CName>(entities.back().id)->name = name;
-    return entities.back().id;
+    else
+    {
+        newIndex = EntityIndex(entities.size());
+        entities.push_back({ EntityID::New(newIndex, 0) });
+    }
+    nActiveEntities++;
+
+    // New entities start out in the empty archetype
+    EntityDesc& desc = entities[newIndex];
+    desc.pArchetype = GetOrCreateArchetype(ComponentMask());
+    desc.pArchetype->AllocateRow(desc.id, desc.chunk, desc.row);
+
+    EntityID id = desc.id;
+#if ATHENA_ENTITY_NAMES
+    if (name != nullptr)
+        Assign<CName>(id)->name = InternedString(name);
+#endif
+    return id;
+}
+
+// ***********************************************************************
+
+void Scene::NewEntities(uint32_t count, const ComponentMask& mask, EntityID* pOutIds)
+{
+    for (uint32_t componentId = uint32_t(mask.find_first()); componentId < MAX_COMPONENTS; componentId = uint32_t(mask.find_next(componentId)))
+    {
+        ASSERT(componentId < componentPools.size() && componentPools[componentId] != nullptr, "Components must have a pool before entities can be made with them in bulk");
+    }
+    Archetype* pArchetype = GetOrCreateArchetype(mask);
+    if (IsHierarchyChange(ComponentMask(), mask))
+        hierarchyChanged = true;
+
+    // Reactive systems need the ids even if the caller doesn't
+    eastl::vector<EntityID> newIds;
+    if (pOutIds == nullptr)
+    {
+        for (ComponentPool* pPool : pArchetype->columnPools)
+        {
+            if (pPool->ReactsToAdd())
+            {
+                newIds.resize(count);
+                pOutIds = newIds.data();
+                break;
+            }
+        }
+    }
+
+    // Reserve all the new slots in one step
+    if (count > freeEntities.size())
+        entities.reserve(entities.size() + count - freeEntities.size());
+    nActiveEntities += count;
+
+    uint32_t nMade = 0;
+    while (nMade < count)
+    {
+        uint32_t chunk;
+        uint32_t firstRow;
+        uint32_t nRows = pArchetype->AllocateRows(count - nMade, chunk, firstRow);
+        ArchetypeChunk* pChunk = pArchetype->chunks[chunk];
+        EntityID* pChunkEntities = pArchetype->GetEntities(pChunk) + firstRow;
+
+        for (uint32_t i = 0; i < nRows; i++)
+        {
+            EntityIndex newIndex;
+            if (!freeEntities.empty())
+            {
+                newIndex = freeEntities.back();
+                freeEntities.pop_back();
+                entities[newIndex].id = EntityID::New(newIndex, entities[newIndex].id.Version());
+            }
+            else
+            {
+                newIndex = EntityIndex(entities.size());
+                entities.push_back({ EntityID::New(newIndex, 0) });
+            }
+
+            EntityDesc& desc = entities[newIndex];
+            desc.pArchetype = pArchetype;
+            desc.chunk = chunk;
+            desc.row = firstRow + i;
+            pChunkEntities[i] = desc.id;
+            if (pOutIds)
+                pOutIds[nMade + i] = desc.id;
+        }
+
+        // Construct the new rows one column at a time, trivial types just copy the first one along
+        for (int column = 0; column < (int)pArchetype->componentIds.size(); column++)
+        {
+            ComponentPool* pPool = pArchetype->columnPools[column];
+            char* pFirst = static_cast<char*>(pArchetype->GetComponent(pChunk, column, firstRow));
+            if (pPool->isTriviallyCopyable)
+            {
+                pPool->pTypeData->pTypeOps->PlacementNew(pFirst);
+                for (uint32_t nDone = 1; nDone < nRows; nDone *= 2)
+                {
+                    memcpy(pFirst + nDone * pPool->elementSize, pFirst, eastl::min(nDone, nRows - nDone) * pPool->elementSize);
+                }
+            }
+            else
+            {
+                for (uint32_t i = 0; i < nRows; i++)
+                {
+                    pPool->pTypeData->pTypeOps->PlacementNew(pFirst + i * pPool->elementSize);
+                }
+            }
+            pPool->nEntities += nRows;
+        }
+        nMade += nRows;
+    }
+
+    for (ComponentPool* pPool : pArchetype->columnPools)
+    {
+        for (ReactiveSystemFunc func : pPool->onAddedCallbacks)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                func(*this, pOutIds[i]);
+            }
+        }
+        if (!pPool->onAddedBatchCallbacks.empty())
+            pPool->pendingAdded.insert(pPool->pendingAdded.end(), pOutIds, pOutIds + count);
+    }
 }
 
 // ***********************************************************************
 
 void Scene::DestroyEntity(EntityID id)
 {
-    if (!id.IsValid())
+    if (!id.IsValid() || entities[id.Index()].id != id)
         return;
 
+    // Only the entity's own components, no need to check every pool
+    Archetype* pArchetype = entities[id.Index()].pArchetype;
+    for (ComponentPool* pPool : pArchetype->columnPools)
+    {
+        pPool->OnRemoved(*this, id);
+    }
+    ReleaseEntity(id);
+}
+
+// ***********************************************************************
+
+void Scene::DestroyEntities(const EntityID* pIds, size_t count)
+{
+    // Reactive systems hear about all of one component type at a time
     for (ComponentPool* pPool : componentPools)
     {
-        if (pPool != nullptr && pPool->pTypeData->IsValid() && Has(id, *(pPool->pTypeData)))
+        if (pPool == nullptr || !pPool->ReactsToRemove())
+            continue;
+
+        for (size_t i = 0; i < count; i++)
         {
-            for (ReactiveSystemFunc func : pPool->onRemovedCallbacks)
-            {
-                func(*this, id);
-            }
-            pPool->Erase(id.Index());
+            EntityID id = pIds[i];
+            if (!id.IsValid() || entities[id.Index()].id != id || !entities[id.Index()].pArchetype->mask.test(pPool->componentId))
+                continue;
+
+            pPool->OnRemoved(*this, id);
         }
     }
+
+    // Release from the back of each archetype first, so most rows can be dropped without filling the hole
+    eastl::vector<EntityID> sorted;
+    sorted.reserve(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        EntityID id = pIds[i];
+        if (id.IsValid() && entities[id.Index()].id == id)
+            sorted.push_back(id);
+    }
+    eastl::sort(sorted.begin(), sorted.end(), [this](EntityID a, EntityID b) {
+        const EntityDesc& descA = entities[a.Index()];
+        const EntityDesc& descB = entities[b.Index()];
+        if (descA.pArchetype != descB.pArchetype)
+            return descA.pArchetype < descB.pArchetype;
+        if (descA.chunk != descB.chunk)
+            return descA.chunk > descB.chunk;
+        return descA.row > descB.row;
+    });
+
+    for (EntityID id : sorted)
+    {
+        // Duplicates in the list will already be gone
+        if (entities[id.Index()].id == id)
+            ReleaseEntity(id);
+    }
+}
+
+// ***********************************************************************
+
+void Scene::ReleaseEntity(EntityID id)
+{
+    for (ComponentPool* pPool : entities[id.Index()].pArchetype->columnPools)
+    {
+        pPool->nEntities--;
+    }
+    MoveEntity(id.Index(), nullptr);
     entities[id.Index()].id = EntityID::New(EntityIndex(-1), id.Version() + 1); // set to invalid
-    entities[id.Index()].mask.reset(); // clear components
     freeEntities.push_back(id.Index());
     nActiveEntities--;
 }
 
 // ***********************************************************************
 
-eastl::string Scene::GetEntityName(EntityID entity)
+const char* Scene::GetEntityName(EntityID entity)
 {
-    return Get<CName>(entity)->name;
+    if (!Has<CName>(entity))
+        return "";
+    return Read<CName>(entity)->name.c_str();
+}
+
+// ***********************************************************************
+
+EntityID Scene::FindEntity(const char* name)
+{
+#if ATHENA_ENTITY_NAMES
+    // Nothing can be called this if the name was never interned
+    uint32_t nameId = StringTable::Find(name);
+    if (nameId == StringTable::InvalidId)
+        return EntityID::InvalidID();
+
+    // Catch up with any names that have been given or changed since last time
+    ComponentPool* pNamePool = GetOrCreateComponentPool<CName>();
+    if (pNamePool->changeVersion > nameIndexVersion)
+    {
+        // Start over if dead entries are piling up, so churning named entities doesn't grow the index forever
+        if (nameIndex.size() > size_t(pNamePool->nEntities) * 2 + 64)
+        {
+            nameIndex.clear();
+            nameIndexVersion = 0;
+        }
+
+        for (SceneChunk chunk : SceneChunkIterator<Changed<CName>>(*this, nameIndexVersion))
+        {
+            const CName* pNames = chunk.Read<CName>();
+            const EntityID* pEntities = chunk.GetEntities();
+            for (uint32_t i = 0; i < chunk.Count(); i++)
+            {
+                auto range = nameIndex.equal_range(pNames[i].name.id);
+                auto it = range.first;
+                while (it != range.second && it->second != pEntities[i])
+                    ++it;
+                if (it == range.second)
+                    nameIndex.insert(eastl::make_pair(pNames[i].name.id, pEntities[i]));
+            }
+        }
+        nameIndexVersion = AdvanceChangeVersion();
+    }
+
+    // The index is a hash map, so duplicates come out in no particular order
+    EntityID found = EntityID::InvalidID();
+    auto range = nameIndex.equal_range(nameId);
+    for (auto it = range.first; it != range.second;)
+    {
+        // Restoring a snapshot can shrink the entity list, so check it's still in range
+        EntityID id = it->second;
+        if (id.Index() < entities.size() && Has<CName>(id) && Read<CName>(id)->name.id == nameId)
+        {
+            if (!found.IsValid() || id.Index() < found.Index())
+                found = id;
+            ++it;
+            continue;
+        }
+
+        // Destroyed, or renamed since it was indexed
+        it = nameIndex.erase(it);
+    }
+    return found;
+#else
+    return EntityID::InvalidID();
+#endif
 }
 
 // ***********************************************************************
@@ -200,6 +723,7 @@ void Scene::SetParent(EntityID child, EntityID parent)
         Get<CChild>(current)->next = child;
     }
     pParent->nChildren += 1;
+    hierarchyChanged = true;
 }
 
 // ***********************************************************************
@@ -228,22 +752,62 @@ void Scene::UnsetParent(EntityID child, EntityID parent)
     
     Remove<CChild>(child);
     pParent->nChildren -= 1;
+    hierarchyChanged = true;
 }
 
 // ***********************************************************************
 
-void Scene::RegisterSystem(SystemPhase phase, SystemFunc func)
+void Scene::RebuildTransformHierarchy()
+{
+    transformHierarchy.clear();
+
+    for (SceneChunk chunk : SceneChunkIterator<CTransform, CParent, Without<CChild>>(*this))
+    {
+        EntityID* pEntities = chunk.GetEntities();
+        for (uint32_t i = 0; i < chunk.Count(); i++)
+        {
+            transformHierarchy.push_back({ pEntities[i], -1, nullptr, false });
+        }
+    }
+
+    // Breadth first, so each depth is added after the one above it
+    // Links are only read, so rebuilding doesn't count as changing every CParent and CChild
+    for (size_t i = 0; i < transformHierarchy.size(); i++)
+    {
+        const CParent* pParent = TryRead<CParent>(transformHierarchy[i].id);
+        if (pParent == nullptr)
+            continue;
+
+        // Destroyed children aren't unlinked, so stop at the first stale one
+        EntityID child = pParent->firstChild;
+        for (int c = 0; c < pParent->nChildren; c++)
+        {
+            const CChild* pChild = TryRead<CChild>(child);
+            if (pChild == nullptr)
+                break;
+
+            if (Has<CTransform>(child))
+                transformHierarchy.push_back({ child, int(i), nullptr, false });
+            child = pChild->next;
+        }
+    }
+    hierarchyChanged = false;
+}
+
+// ***********************************************************************
+
+void Scene::RegisterSystem(SystemPhase phase, SystemFunc func, const SystemAccess& access)
 {
     switch (phase)
     {
     case SystemPhase::PreUpdate:
-        preUpdateSystems.push_back(func);
+        preUpdateSystems.Add(func, access);
         break;			
     case SystemPhase::Update:
-        updateSystems.push_back(func);
+        updateSystems.Add(func, access);
         break;
     case SystemPhase::Render:
-        renderSystems.push_back(func);
+        renderSystems.Add(func, access);
         break;
     default:
         break;
@@ -254,24 +818,113 @@ void Scene::RegisterSystem(SystemPhase phase, SystemFunc func)
 
 void Scene::SimulateScene(float deltaTime)
 {
-    for (SystemFunc func : preUpdateSystems)
-    {
-        func(*this, deltaTime);
-    }
-    for (SystemFunc func : updateSystems)
+    FlushReactiveEvents();
+    preUpdateSystems.Run(*this, deltaTime);
+    FlushReactiveEvents();
+    updateSystems.Run(*this, deltaTime);
+    FlushReactiveEvents();
+}
+
+// ***********************************************************************
+
+void Scene::RenderScene(float deltaTime)
+{
+    renderSystems.Run(*this, deltaTime);
+}
+
+// ***********************************************************************
+
+bool SystemAccess::ConflictsWith(const SystemAccess& other) const
+{
+    if (exclusive || other.exclusive)
+        return true;
+    return MaskIntersects(writes, other.reads) || MaskIntersects(writes, other.writes) || MaskIntersects(reads, other.writes);
+}
+
+// ***********************************************************************
+
+void SystemSchedule::Add(SystemFunc func, const SystemAccess& access)
+{
+    uint32_t newIndex = (uint32_t)systems.size();
+    systems.push_back();
+    Node& newNode = systems.back();
+    newNode.func = func;
+    newNode.access = access;
+
+    for (uint32_t i = 0; i < newIndex; i++)
     {
-        func(*this, deltaTime);
+        if (systems[i].access.ConflictsWith(access))
+        {
+            systems[i].dependents.push_back(newIndex);
+            newNode.nDependencies++;
+        }
     }
 }
 
 // ***********************************************************************
 
-void Scene::RenderScene(float deltaTime)
+void SystemSchedule::Run(Scene& scene, float _deltaTime)
 {
-    for (SystemFunc func : renderSystems)
+    // Nothing to run in parallel with, registration order is always a valid order
+    if (systems.size() < 2 || Jobs::GetWorkerCount() == 0)
+    {
+        for (Node& node : systems)
+        {
+            node.func(scene, _deltaTime);
+        }
+        return;
+    }
+
+    pScene = &scene;
+    deltaTime = _deltaTime;
+    readySystems.clear();
+    for (uint32_t i = 0; i < systems.size(); i++)
     {
-        func(*this, deltaTime);
+        systems[i].pSchedule = this;
+        systems[i].nWaiting = systems[i].nDependencies;
+        if (systems[i].nDependencies == 0)
+            readySystems.push_back(i);
     }
+
+    while (!readySystems.empty())
+    {
+        // Exclusive systems conflict with everything, so they're only ever ready on their own, and run here like
+        // any other system with nothing to run alongside it. Queueing those would only add a trip to a worker
+        if (readySystems.size() == 1)
+        {
+            RunNode(&systems[readySystems[0]]);
+        }
+        else
+        {
+            for (uint32_t index : readySystems)
+            {
+                Jobs::Run(RunNode, &systems[index], &counter);
+            }
+            Jobs::Wait(&counter);
+        }
+
+        // Kept in registration order, so each pass starts its systems in a deterministic order
+        nextReadySystems.clear();
+        for (uint32_t index : readySystems)
+        {
+            for (uint32_t dependent : systems[index].dependents)
+            {
+                if (--systems[dependent].nWaiting == 0)
+                    nextReadySystems.push_back(dependent);
+            }
+        }
+        eastl::sort(nextReadySystems.begin(), nextReadySystems.end());
+        readySystems.swap(nextReadySystems);
+    }
+}
+
+// ***********************************************************************
+
+void SystemSchedule::RunNode(void* pData)
+{
+    Node* pNode = static_cast<Node*>(pData);
+    SystemSchedule* pSchedule = pNode->pSchedule;
+    pNode->func(*pSchedule->pScene, pSchedule->deltaTime);
 }
 
 // ***********************************************************************
@@ -284,14 +937,13 @@ void Scene::Assign(EntityID id, TypeData& componentType)
     ComponentPool *pPool = GetOrCreateComponentPool(componentType);
     ASSERT(Has(id, componentType) == false, "You're trying to assign a component to an entity that already has this component");
 
-    componentType.pTypeOps->PlacementNew(pPool->GetRaw(id.Index()));
+    EntityDesc& desc = entities[id.Index()];
+    MoveEntity(id.Index(), GetArchetypeWith(desc.pArchetype, pPool->componentId));
 
-    entities[id.Index()].mask.set(componentType.id);
+    componentType.pTypeOps->PlacementNew(GetRaw(id.Index(), pPool->componentId));
+    pPool->nEntities++;
 
-    for (ReactiveSystemFunc func : pPool->onAddedCallbacks)
-    {
-        func(*this, id);
-    }
+    pPool->OnAdded(*this, id);
 }
 
 // ***********************************************************************
@@ -303,13 +955,13 @@ void Scene::Remove(EntityID id, TypeData& componentType)
 
     ASSERT(Has(id, componentType), "The component you're trying to access is not assigned to this entity");
 
-    int componentId = componentType.id;
-    for (ReactiveSystemFunc func : componentPools[componentId]->onRemovedCallbacks)
-    {
-        func(*this, id);
-    }
-    entities[id.Index()].mask.reset(componentId);
-    componentPools[componentId]->Erase(id.Index());
+    uint32_t componentId = Component::Index(componentType);
+    ComponentPool* pPool = componentPools[componentId];
+    pPool->OnRemoved(*this, id);
+
+    EntityDesc& desc = entities[id.Index()];
+    pPool->nEntities--;
+    MoveEntity(id.Index(), GetArchetypeWithout(desc.pArchetype, componentId)); // Destructs the removed component
 }
 
 // ***********************************************************************
@@ -321,7 +973,7 @@ Variant Scene::Get(EntityID id, TypeData& componentType)
 
     ASSERT(Has(id, componentType), "The component you're trying to access is not assigned to this entity");
 
-    void* pData = componentPools[componentType.id]->GetRaw(id.Index());
+    void* pData = GetRaw(id.Index(), Component::Index(componentType));
     return componentType.pTypeOps->CopyToVariant(pData);
 }
 
@@ -332,12 +984,22 @@ void Scene::Set(EntityID id, Variant componentToSet)
     if (entities[id.Index()].id != id)
         return;
     
-    int componentId = componentToSet.GetType().id;
+    uint32_t componentId = Component::Index(componentToSet.GetType());
 
     ASSERT(Has(id, componentToSet.GetType()), "The component you're trying to set data on is not assigned to this entity");
 
-    void* pData = componentPools[componentId]->GetRaw(id.Index());
+    void* pData = GetRaw(id.Index(), componentId);
     componentToSet.GetType().pTypeOps->Copy(pData, componentToSet.pData);
+
+    EntityDesc& desc = entities[id.Index()];
+    desc.pArchetype->MarkChanged(desc.pArchetype->chunks[desc.chunk], desc.pArchetype->GetColumn(componentId));
+}
+
+// ***********************************************************************
+
+uint32_t Scene::AdvanceChangeVersion()
+{
+    return changeVersion++;
 }
 
 // ***********************************************************************
@@ -347,7 +1009,7 @@ bool Scene::Has(EntityID id, TypeData &type)
     if (!id.IsValid() || entities[id.Index()].id != id) // ensures you're not accessing an entity that has been deleted
         return false;
 
-    return entities[id.Index()].mask.test(type.id);
+    return entities[id.Index()].pArchetype->mask.test(Component::Index(type));
 }
 
 // ***********************************************************************
@@ -371,17 +1033,473 @@ void Scene::RegisterReactiveSystem(Reaction reaction, ReactiveSystemFunc func, T
 
 // ***********************************************************************
 
+void Scene::RegisterReactiveSystem(Reaction reaction, ReactiveBatchFunc func, TypeData& type)
+{
+    ComponentPool *pPool = GetOrCreateComponentPool(type);
+
+    switch (reaction)
+    {
+    case Reaction::OnAdd:
+        pPool->onAddedBatchCallbacks.push_back(func);
+        break;
+    case Reaction::OnRemove:
+        pPool->onRemovedBatchCallbacks.push_back(func);
+        break;
+    default:
+        break;
+    }
+}
+
+// ***********************************************************************
+
+void Scene::FlushReactiveEvents()
+{
+    for (ComponentPool* pPool : componentPools)
+    {
+        if (pPool == nullptr)
+            continue;
+
+        // Taken out of the pool first, anything the callbacks do waits for the next flush
+        if (!pPool->pendingRemoved.empty())
+        {
+            reactiveEvents.swap(pPool->pendingRemoved);
+            for (ReactiveBatchFunc func : pPool->onRemovedBatchCallbacks)
+            {
+                func(*this, reactiveEvents.data(), reactiveEvents.size());
+            }
+            reactiveEvents.clear();
+        }
+
+        if (!pPool->pendingAdded.empty())
+        {
+            reactiveEvents.swap(pPool->pendingAdded);
+
+            // Drop entities that were destroyed or lost the component again before the flush
+            uint32_t componentId = pPool->componentId;
+            EntityID* pEnd = eastl::remove_if(reactiveEvents.begin(), reactiveEvents.end(), [this, componentId](EntityID id) {
+                return entities[id.Index()].id != id || !entities[id.Index()].pArchetype->mask.test(componentId);
+            });
+            reactiveEvents.erase(pEnd, reactiveEvents.end());
+
+            for (ReactiveBatchFunc func : pPool->onAddedBatchCallbacks)
+            {
+                if (!reactiveEvents.empty())
+                    func(*this, reactiveEvents.data(), reactiveEvents.size());
+            }
+            reactiveEvents.clear();
+        }
+    }
+}
+
+// ***********************************************************************
+
 ComponentPool* Scene::GetOrCreateComponentPool(TypeData& type)
 {
-    uint32_t componentId = type.id;
+    uint32_t componentId = Component::Index(type);
     if (componentPools.size() <= componentId) // Not enough component pool
         componentPools.resize(componentId + 1, nullptr);
 
     if (componentPools[componentId] == nullptr) // New component, make a new pool
     {	
-        componentPools[componentId] = new ComponentPool(type.size, type, [](void *pComponent, TypeData* pTypeData) {
+        componentPools[componentId] = new ComponentPool(componentId, type.size, type, [](void *pComponent, TypeData* pTypeData) {
             pTypeData->pTypeOps->Destruct(pComponent);
+        }, [](void* pDestination, void* pSource, TypeData* pTypeData) {
+            pTypeData->pTypeOps->Move(pDestination, pSource);
         });
     }
     return componentPools[componentId];
+}
+
+// ***********************************************************************
+
+Archetype* Scene::GetOrCreateArchetype(const ComponentMask& mask)
+{
+    for (Archetype* pArchetype : archetypes)
+    {
+        if (MaskEquals(pArchetype->mask, mask))
+            return pArchetype;
+    }
+    Archetype* pNewArchetype = new Archetype(*this, mask);
+    archetypes.push_back(pNewArchetype);
+
+    // Keep registered queries up to date
+    for (SceneQuery* pQuery : queries)
+    {
+        if (pQuery == nullptr)
+            continue;
+
+        uint64_t start = SDL_GetPerformanceCounter();
+        if (pQuery->Matches(mask))
+            pQuery->archetypes.push_back(pNewArchetype);
+        pQuery->nArchetypeTests++;
+        pQuery->maintenanceTicks += SDL_GetPerformanceCounter() - start;
+    }
+    return pNewArchetype;
+}
+
+// ***********************************************************************
+
+SceneQuery* Scene::RegisterQuery(uint32_t queryId, const ComponentMask& mask, const ComponentMask& excludeMask, const ComponentMask& changedMask, const eastl::string& name)
+{
+    if (queries.size() <= queryId)
+        queries.resize(queryId + 1, nullptr);
+
+    uint64_t start = SDL_GetPerformanceCounter();
+
+    SceneQuery* pQuery = new SceneQuery();
+    pQuery->mask = mask;
+    pQuery->excludeMask = excludeMask;
+    pQuery->changedMask = changedMask;
+    pQuery->name = name;
+
+    for (Archetype* pArchetype : GetCandidateArchetypes(mask))
+    {
+        if (pQuery->Matches(pArchetype->mask))
+            pQuery->archetypes.push_back(pArchetype);
+        pQuery->nArchetypeTests++;
+    }
+    pQuery->maintenanceTicks += SDL_GetPerformanceCounter() - start;
+
+    queries[queryId] = pQuery;
+    return pQuery;
+}
+
+// ***********************************************************************
+
+uint32_t SceneQuery::NewQueryId()
+{
+    static SDL_atomic_t queryCounter{ 0 };
+    return (uint32_t)SDL_AtomicAdd(&queryCounter, 1);
+}
+
+// ***********************************************************************
+
+uint32_t SceneQuery::CountEntities() const
+{
+    uint32_t count = 0;
+    for (Archetype* pArchetype : archetypes)
+    {
+        count += pArchetype->nEntities;
+    }
+    return count;
+}
+
+// ***********************************************************************
+
+double SceneQuery::GetMaintenanceMs() const
+{
+    return double(maintenanceTicks) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+// ***********************************************************************
+
+const eastl::vector<Archetype*>& Scene::GetCandidateArchetypes(const ComponentMask& mask)
+{
+    if (mask.none())
+        return archetypes;
+
+    ComponentPool* pSmallest = nullptr;
+    for (uint32_t componentId = uint32_t(mask.find_first()); componentId < MAX_COMPONENTS; componentId = uint32_t(mask.find_next(componentId)))
+    {
+        if (componentId >= componentPools.size() || componentPools[componentId] == nullptr)
+            return noArchetypes;
+
+        ComponentPool* pPool = componentPools[componentId];
+        if (pSmallest == nullptr || pPool->nEntities < pSmallest->nEntities)
+            pSmallest = pPool;
+    }
+    return pSmallest->archetypes;
+}
+
+// ***********************************************************************
+
+Archetype* Scene::GetArchetypeWith(Archetype* pArchetype, uint32_t componentId)
+{
+    eastl::map<uint32_t, Archetype*>::iterator edge = pArchetype->addEdges.find(componentId);
+    if (edge != pArchetype->addEdges.end())
+        return edge->second;
+
+    ComponentMask newMask = pArchetype->mask;
+    newMask.set(componentId);
+    Archetype* pNewArchetype = GetOrCreateArchetype(newMask);
+    pArchetype->addEdges[componentId] = pNewArchetype;
+    return pNewArchetype;
+}
+
+// ***********************************************************************
+
+Archetype* Scene::GetArchetypeWithout(Archetype* pArchetype, uint32_t componentId)
+{
+    eastl::map<uint32_t, Archetype*>::iterator edge = pArchetype->removeEdges.find(componentId);
+    if (edge != pArchetype->removeEdges.end())
+        return edge->second;
+
+    ComponentMask newMask = pArchetype->mask;
+    newMask.reset(componentId);
+    Archetype* pNewArchetype = GetOrCreateArchetype(newMask);
+    pArchetype->removeEdges[componentId] = pNewArchetype;
+    return pNewArchetype;
+}
+
+// ***********************************************************************
+
+ArchetypeChunk* Scene::AllocateChunk(size_t nColumns)
+{
+    nActiveChunks++;
+
+    ArchetypeChunk* pChunk;
+    if (!idleChunks.empty())
+    {
+        // Idle chunks keep their vectors' capacity, so this only allocates if the last archetype had fewer columns
+        pChunk = idleChunks.back();
+        idleChunks.pop_back();
+    }
+    else
+    {
+        pChunk = new ArchetypeChunk();
+        if (!decommittedChunks.empty())
+        {
+            pChunk->pData = decommittedChunks.back();
+            decommittedChunks.pop_back();
+            chunkArena.Recommit(pChunk->pData, ARCHETYPE_CHUNK_SIZE);
+        }
+        else
+        {
+            pChunk->pData = static_cast<char*>(chunkArena.Allocate(ARCHETYPE_CHUNK_SIZE, ARCHETYPE_CHUNK_ALIGNMENT));
+        }
+    }
+
+    pChunk->count = 0;
+    pChunk->columnVersions.assign(nColumns, 0);
+    pChunk->snapshotColumns.resize(nColumns);
+    pChunk->snapshotVersions.assign(nColumns, 0);
+    return pChunk;
+}
+
+// ***********************************************************************
+
+void Scene::FreeChunk(ArchetypeChunk* pChunk)
+{
+    nActiveChunks--;
+
+    // Idle chunks mustn't keep old snapshot columns alive
+    pChunk->snapshotColumns.clear();
+
+    // Keeping a few around stops us thrashing the OS and the heap when an archetype hovers around a chunk boundary
+    // The rest keep their place in the arena, but their pages are given back until they're needed again
+    if (idleChunks.size() < MAX_IDLE_CHUNKS)
+    {
+        idleChunks.push_back(pChunk);
+    }
+    else
+    {
+        chunkArena.Decommit(pChunk->pData, ARCHETYPE_CHUNK_SIZE);
+        decommittedChunks.push_back(pChunk->pData);
+        delete pChunk;
+    }
+}
+
+// ***********************************************************************
+
+size_t Scene::GetResidentBytes()
+{
+    return chunkArena.GetCommittedBytes();
+}
+
+// ***********************************************************************
+
+SceneSnapshot Scene::Snapshot()
+{
+    SceneSnapshot snapshot;
+    snapshot.pScene = this;
+    snapshot.nActiveEntities = nActiveEntities;
+    snapshot.entities = entities;
+    snapshot.freeEntities = freeEntities;
+    snapshot.poolEntityCounts.resize(componentPools.size(), 0);
+    for (ComponentPool* pPool : componentPools)
+    {
+        if (pPool)
+            snapshot.poolEntityCounts[pPool->componentId] = pPool->nEntities;
+    }
+
+    snapshot.archetypes.resize(archetypes.size());
+    for (size_t i = 0; i < archetypes.size(); i++)
+    {
+        Archetype* pArchetype = archetypes[i];
+        SceneSnapshot::ArchetypeState& archetypeState = snapshot.archetypes[i];
+        archetypeState.pArchetype = pArchetype;
+        archetypeState.chunks.resize(pArchetype->chunks.size());
+
+        for (size_t chunk = 0; chunk < pArchetype->chunks.size(); chunk++)
+        {
+            ArchetypeChunk* pChunk = pArchetype->chunks[chunk];
+            SceneSnapshot::ChunkState& chunkState = archetypeState.chunks[chunk];
+            EntityID* pEntities = pArchetype->GetEntities(pChunk);
+            chunkState.count = pChunk->count;
+            chunkState.entities.assign(pEntities, pEntities + pChunk->count);
+            chunkState.columns.resize(pArchetype->componentIds.size());
+
+            for (int column = 0; column < (int)pArchetype->componentIds.size(); column++)
+            {
+                eastl::shared_ptr<SnapshotColumn>& pLast = pChunk->snapshotColumns[column];
+                bool unchanged = pLast && pChunk->snapshotVersions[column] == pChunk->columnVersions[column] && pLast->count == pChunk->count;
+                if (!unchanged)
+                {
+                    pLast = eastl::make_shared<SnapshotColumn>(pArchetype->columnPools[column], pArchetype->GetComponent(pChunk, column, 0), pChunk->count);
+                    pChunk->snapshotVersions[column] = pChunk->columnVersions[column];
+                }
+                chunkState.columns[column] = pLast;
+            }
+        }
+    }
+
+    // Anything changed from here on gets a newer version than the columns we just shared
+    AdvanceChangeVersion();
+    return snapshot;
+}
+
+// ***********************************************************************
+
+void Scene::Restore(const SceneSnapshot& snapshot)
+{
+    ASSERT(snapshot.pScene == this, "Snapshots can only be restored to the scene they were taken from");
+
+    for (size_t i = 0; i < archetypes.size(); i++)
+    {
+        Archetype* pArchetype = archetypes[i];
+        const SceneSnapshot::ArchetypeState* pArchetypeState = i < snapshot.archetypes.size() ? &snapshot.archetypes[i] : nullptr;
+        ASSERT(pArchetypeState == nullptr || pArchetypeState->pArchetype == pArchetype, "Snapshot archetypes don't match the scene");
+        size_t nChunks = pArchetypeState ? pArchetypeState->chunks.size() : 0;
+
+        // Chunks the snapshot doesn't have go entirely
+        while (pArchetype->chunks.size() > nChunks)
+        {
+            ArchetypeChunk* pChunk = pArchetype->chunks.back();
+            for (int column = 0; column < (int)pArchetype->componentIds.size(); column++)
+            {
+                ComponentPool* pPool = pArchetype->columnPools[column];
+                for (uint32_t row = 0; row < pChunk->count; row++)
+                {
+                    pPool->pDestructor(pArchetype->GetComponent(pChunk, column, row), pPool->pTypeData);
+                }
+            }
+            pArchetype->chunks.pop_back();
+            pArchetype->FreeChunk(pChunk);
+        }
+
+        pArchetype->nEntities = 0;
+        for (size_t chunk = 0; chunk < nChunks; chunk++)
+        {
+            const SceneSnapshot::ChunkState& chunkState = pArchetypeState->chunks[chunk];
+            ArchetypeChunk* pChunk = chunk < pArchetype->chunks.size() ? pArchetype->chunks[chunk] : pArchetype->NewChunk();
+
+            for (int column = 0; column < (int)pArchetype->componentIds.size(); column++)
+            {
+                // Columns untouched since this snapshot was taken or restored already hold the right data
+                const eastl::shared_ptr<SnapshotColumn>& pSaved = chunkState.columns[column];
+                if (pChunk->snapshotColumns[column] == pSaved && pChunk->snapshotVersions[column] == pChunk->columnVersions[column] && pChunk->count == chunkState.count)
+                    continue;
+
+                ComponentPool* pPool = pArchetype->columnPools[column];
+                for (uint32_t row = 0; row < pChunk->count; row++)
+                {
+                    pPool->pDestructor(pArchetype->GetComponent(pChunk, column, row), pPool->pTypeData);
+                }
+                pSaved->CopyTo(pArchetype->GetComponent(pChunk, column, 0));
+
+                pArchetype->MarkChanged(pChunk, column);
+                pChunk->snapshotColumns[column] = pSaved;
+                pChunk->snapshotVersions[column] = pChunk->columnVersions[column];
+            }
+
+            memcpy(pArchetype->GetEntities(pChunk), chunkState.entities.data(), chunkState.count * sizeof(EntityID));
+            pChunk->count = chunkState.count;
+            pArchetype->nEntities += chunkState.count;
+        }
+    }
+
+    nActiveEntities = snapshot.nActiveEntities;
+    entities = snapshot.entities;
+    freeEntities = snapshot.freeEntities;
+    for (ComponentPool* pPool : componentPools)
+    {
+        if (pPool == nullptr)
+            continue;
+
+        uint32_t componentId = pPool->componentId;
+        pPool->nEntities = componentId < snapshot.poolEntityCounts.size() ? snapshot.poolEntityCounts[componentId] : 0;
+        pPool->pendingAdded.clear();
+        pPool->pendingRemoved.clear();
+    }
+
+    // Cached transform hierarchy points into chunks that may have changed
+    hierarchyChanged = true;
+    AdvanceChangeVersion();
+}
+
+// ***********************************************************************
+
+void Scene::MoveEntity(EntityIndex index, Archetype* pNewArchetype)
+{
+    EntityDesc& desc = entities[index];
+    Archetype* pOld = desc.pArchetype;
+    ArchetypeChunk* pOldChunk = pOld->chunks[desc.chunk];
+    uint32_t oldRow = desc.row;
+
+    // Entities joining or leaving a transform hierarchy change its shape
+    ComponentMask newMask = pNewArchetype ? pNewArchetype->mask : ComponentMask();
+    if (IsHierarchyChange(pOld->mask, newMask))
+        hierarchyChanged = true;
+
+    // Move over the components both archetypes share, destroying the rest
+    uint32_t newChunk = 0;
+    uint32_t newRow = 0;
+    if (pNewArchetype)
+        pNewArchetype->AllocateRow(desc.id, newChunk, newRow);
+
+    for (int column = 0; column < (int)pOld->componentIds.size(); column++)
+    {
+        ComponentPool* pPool = pOld->columnPools[column];
+        void* pSource = pOld->GetComponent(pOldChunk, column, oldRow);
+
+        int newColumn = pNewArchetype ? pNewArchetype->GetColumn(pOld->componentIds[column]) : -1;
+        if (newColumn >= 0)
+            pPool->pMove(pNewArchetype->GetComponent(pNewArchetype->chunks[newChunk], newColumn, newRow), pSource, pPool->pTypeData);
+        else
+            pPool->pDestructor(pSource, pPool->pTypeData);
+    }
+
+    // Fill the hole with the last entity in the old archetype so chunks stay packed
+    ArchetypeChunk* pLastChunk = pOld->chunks.back();
+    uint32_t lastRow = pLastChunk->count - 1;
+    if (pLastChunk != pOldChunk || lastRow != oldRow)
+    {
+        EntityID movedEntity = pOld->GetEntities(pLastChunk)[lastRow];
+        for (int column = 0; column < (int)pOld->componentIds.size(); column++)
+        {
+            ComponentPool* pPool = pOld->columnPools[column];
+            pPool->pMove(pOld->GetComponent(pOldChunk, column, oldRow), pOld->GetComponent(pLastChunk, column, lastRow), pPool->pTypeData);
+        }
+        pOld->GetEntities(pOldChunk)[oldRow] = movedEntity;
+        for (int column = 0; column < (int)pOld->componentIds.size(); column++)
+        {
+            pOld->MarkChanged(pOldChunk, column);
+        }
+
+        EntityDesc& movedDesc = entities[movedEntity.Index()];
+        movedDesc.chunk = desc.chunk;
+        movedDesc.row = oldRow;
+    }
+    pLastChunk->count--;
+    pOld->nEntities--;
+
+    if (pLastChunk->count == 0)
+    {
+        pOld->chunks.pop_back();
+        pOld->FreeChunk(pLastChunk);
+    }
+
+    desc.pArchetype = pNewArchetype;
+    desc.chunk = newChunk;
+    desc.row = newRow;
 }
\ No newline at end of file
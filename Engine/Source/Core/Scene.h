@@ -38,6 +38,10 @@ Shape* pShape = scene.Assign<Shape>(triangle);
 EntityID circle = scene.NewEntity();
 scene.Assign<Shape>(circle);
 
+// Entities with the same set of components are stored together in packed archetype chunks,
+// so assigning or removing components moves the entity (and may move another to fill the gap).
+// Don't hold on to component pointers across those calls, fetch them again with Get<T>
+
 // To get the whole thing running, just call your systems ShipControlSystem(scene);
 
 */
@@ -50,9 +54,21 @@ scene.Assign<Shape>(circle);
 #include "Vec3.h"
 #include "Matrix.h"
 #include "Engine.h"
+#include "Jobs.h"
+#include "StringTable.h"
+#include "VirtualArena.h"
 
 #include <EASTL/bitset.h>
 #include <EASTL/vector.h>
+#include <EASTL/map.h>
+#include <EASTL/hash_map.h>
+#include <EASTL/shared_ptr.h>
+#include <type_traits>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define ATHENA_MASK_SSE2
+#endif
 
 struct Scene;
 
@@ -93,12 +109,55 @@ struct EntityID
 	uint64_t value;
 };
 
-const int MAX_COMPONENTS = 50;
-const int MAX_ENTITIES = 1024;
-typedef eastl::bitset<MAX_COMPONENTS> ComponentMask;
+// The number of component types a program can use, set from cmake with ATHENA_MAX_COMPONENTS
+// Masks are compared 128 bits at a time, so keep it a multiple of 128
+#ifndef ATHENA_MAX_COMPONENTS
+#define ATHENA_MAX_COMPONENTS 256
+#endif
+const int MAX_COMPONENTS = ATHENA_MAX_COMPONENTS;
+static_assert(MAX_COMPONENTS % 128 == 0, "ATHENA_MAX_COMPONENTS must be a multiple of 128");
+// Entity names can be compiled out of shipping builds with the ATHENA_ENTITY_NAMES cmake option
+// Without them NewEntity ignores the name it's given and FindEntity never finds anything
+#ifndef ATHENA_ENTITY_NAMES
+#define ATHENA_ENTITY_NAMES 1
+#endif
+
+const size_t ARCHETYPE_CHUNK_SIZE = 16 * 1024;
+const size_t ARCHETYPE_CHUNK_ALIGNMENT = 64;
+const size_t MAX_IDLE_CHUNKS = 8; // Emptied chunks kept around for reuse before their pages are given back
+typedef eastl::bitset<MAX_COMPONENTS, uint64_t> ComponentMask;
+const int COMPONENT_MASK_WORDS = MAX_COMPONENTS / 64;
+
+// Whole mask checks, done with SSE2 where we have it so wide masks cost about the same as a single word
+inline bool MaskContains(const ComponentMask& mask, const ComponentMask& subset);
+inline bool MaskIntersects(const ComponentMask& a, const ComponentMask& b);
+inline bool MaskEquals(const ComponentMask& a, const ComponentMask& b);
+
+// Component types get their own small indices the first time they're used, separate from Type::Index
+// which every reflected type has, so masks only need room for the types actually used as components
+struct Component
+{
+	template<typename T>
+	inline static uint32_t Index()
+	{
+		static uint32_t componentIndex = FromTypeIndex(Type::Index<T>());
+		return componentIndex;
+	}
+
+	static uint32_t Index(TypeData& type) { return FromTypeIndex(type.id); }
+
+	static uint32_t FromTypeIndex(uint32_t typeIndex);
+};
+
 typedef void (*ReactiveSystemFunc)(Scene&, EntityID);
+typedef void (*ReactiveBatchFunc)(Scene&, const EntityID*, size_t);
 typedef void (*SystemFunc)(Scene&, float);
 struct ComponentPool;
+struct Archetype;
+struct ArchetypeChunk;
+struct SceneQuery;
+struct SceneSnapshot;
+struct SnapshotColumn;
 
 enum class Reaction
 {
@@ -118,7 +177,7 @@ enum class SystemPhase
 
 struct CName
 {
-	eastl::string name;
+	InternedString name;
 
 	REFLECT()
 };
@@ -138,6 +197,12 @@ struct CTransform
 
 	Matrixf globalTransform;
 
+	// The local transform globalTransform was last built from, so unchanged transforms can be skipped
+	Vec3f builtPos;
+	Vec3f builtSca;
+	Vec3f builtRot;
+	bool built{false};
+
 	REFLECT()
 };
 
@@ -166,6 +231,75 @@ struct CChild
 
 void TransformHeirarchy(Scene &scene, float deltaTime);
 
+// Component types a system reads and writes, declared when registering it like so:
+// scene.RegisterSystem(SystemPhase::Update, MovementSystem, SystemAccess().Reads<CVelocity>().Writes<CTransform>());
+// Systems that don't conflict are run at the same time on the job workers, so they must stick to what they declared
+// and must not create or destroy entities, or assign or remove components. Components they only read must be accessed
+// with Read, as Get, TryGet and SceneChunk::Get stamp change versions, which would race with other readers.
+// Systems registered without a declaration always run on their own on the thread running the scene, and can do whatever they like
+struct SystemAccess
+{
+	template <typename... ComponentTypes>
+	SystemAccess& Reads()
+	{
+		uint32_t componentIds[] = {0, Component::Index<ComponentTypes>()...};
+		for (size_t i = 1; i <= sizeof...(ComponentTypes); i++)
+			reads.set(componentIds[i]);
+		exclusive = false;
+		return *this;
+	}
+
+	template <typename... ComponentTypes>
+	SystemAccess& Writes()
+	{
+		uint32_t componentIds[] = {0, Component::Index<ComponentTypes>()...};
+		for (size_t i = 1; i <= sizeof...(ComponentTypes); i++)
+			writes.set(componentIds[i]);
+		exclusive = false;
+		return *this;
+	}
+
+	bool ConflictsWith(const SystemAccess& other) const;
+
+	ComponentMask reads;
+	ComponentMask writes;
+	bool exclusive{true};
+};
+
+// The systems of one phase, and the order they need to run in
+// Each system waits on every earlier registered system it conflicts with, so conflicting systems
+// still run in registration order, and the result is the same as running everything one by one
+// Systems are run in passes of every system whose dependencies have finished. A system that's ready on its own,
+// which always includes exclusive ones, runs on the calling thread, and only passes of several go to the job workers
+struct SystemSchedule
+{
+	struct Node
+	{
+		SystemFunc func;
+		SystemAccess access;
+		eastl::vector<uint32_t> dependents;
+		int nDependencies{0};
+
+		SystemSchedule* pSchedule{nullptr};
+		int nWaiting{0}; // Dependencies not yet finished this run
+	};
+
+	void Add(SystemFunc func, const SystemAccess& access);
+
+	void Run(Scene& scene, float deltaTime);
+
+	static void RunNode(void* pData);
+
+	eastl::vector<Node> systems;
+
+	// Only valid during Run
+	Scene* pScene{nullptr};
+	float deltaTime{0.0f};
+	Jobs::Counter counter;
+	eastl::vector<uint32_t> readySystems;
+	eastl::vector<uint32_t> nextReadySystems;
+};
+
 
 // *****************************************
 // A game scene, holds enties and systems
@@ -179,16 +313,28 @@ struct Scene
 	struct EntityDesc
 	{
 		EntityID id;
-		ComponentMask mask;
+
+		// Where this entity's components currently live
+		Archetype* pArchetype{ nullptr };
+		uint32_t chunk{ 0 };
+		uint32_t row{ 0 };
 	};
 
 	Scene();
 	~Scene();
 
 	// Creates an entity, simply makes a new id and mask
+	// Entities only get a CName if you give them a name
 	EntityID NewEntity(const char *name);
 
+	// Creates count entities that all have exactly these default constructed components, in one go
+	// Their ids are written to pOutIds if it's given, and they're not given names
+	template <typename... ComponentTypes>
+	void NewEntities(uint32_t count, EntityID* pOutIds = nullptr);
+	void NewEntities(uint32_t count, const ComponentMask& mask, EntityID* pOutIds = nullptr);
+
 	void DestroyEntity(EntityID id);
+	void DestroyEntities(const EntityID* pIds, size_t count);
 
 	template <typename T>
 	T *Assign(EntityID id);
@@ -202,148 +348,651 @@ struct Scene
 	T *Get(EntityID id);
 	Variant Get(EntityID id, TypeData& componentType);
 
+	// Like Get, but returns nullptr if the entity doesn't have this component
+	template <typename T>
+	T *TryGet(EntityID id);
+
+	// Read only access, which unlike Get doesn't count as changing the component
+	template <typename T>
+	const T *Read(EntityID id);
+
+	// Like Read, but returns nullptr if the entity doesn't have this component
+	template <typename T>
+	const T *TryRead(EntityID id);
+
+	// Components written through Get, TryGet, Set or SceneChunk::Get are stamped with the current change version
+	// Stamps are kept per chunk, and Changed<...> query terms use them to skip chunks that haven't changed
+	// AdvanceChangeVersion returns the current version and starts a new one, keep hold of it to later ask
+	// for everything that changed after this point
+	uint32_t AdvanceChangeVersion();
+
+	template <typename T>
+	void MarkChanged(EntityID id);
+
 	void Set(EntityID id, Variant componentToSet);
 
 	template <typename T>
 	bool Has(EntityID id);
 	bool Has(EntityID id, TypeData &type);
 
-	eastl::string GetEntityName(EntityID entity);
+	// Empty if the entity has no name
+	const char* GetEntityName(EntityID entity);
+
+	// An entity with this name, or an invalid id if there isn't one. If several share the name you get the one with the lowest index
+	// The first call builds a name index, after which lookups only have to catch up with names that have changed since.
+	// Keeping the index up to date changes the scene, so like creating entities, this can't be called from systems running in parallel
+	EntityID FindEntity(const char* name);
 
 	template <typename T>
 	void RegisterReactiveSystem(Reaction reaction, ReactiveSystemFunc func);
 	void RegisterReactiveSystem(Reaction reaction, ReactiveSystemFunc func, TypeData& type);
 
+	// Batched reactive systems aren't called during the change, the entities are queued up per component type
+	// and handed over all at once by FlushReactiveEvents. By then removed components are already gone,
+	// so OnRemove batches only get the ids, and OnAdd batches skip entities that have since lost the component
+	template <typename T>
+	void RegisterReactiveSystem(Reaction reaction, ReactiveBatchFunc func);
+	void RegisterReactiveSystem(Reaction reaction, ReactiveBatchFunc func, TypeData& type);
+
+	// Calls the batched reactive systems with everything queued since the last flush
+	// SimulateScene flushes after each phase, call this yourself to hear about changes sooner
+	void FlushReactiveEvents();
+
 	template <typename T>
 	ComponentPool* GetOrCreateComponentPool();
 	ComponentPool* GetOrCreateComponentPool(TypeData& type);
 
+	Archetype* GetOrCreateArchetype(const ComponentMask& mask);
+
+	// The smallest list of archetypes that could contain all the components in the mask,
+	// taken from whichever component has the fewest entities
+	const eastl::vector<Archetype*>& GetCandidateArchetypes(const ComponentMask& mask);
+
+	// Persistent query for entities with all of these components, made the first time it's asked for
+	// Accepts Without<...> and Optional<...> terms as well as plain component types
+	template <typename... ComponentTypes>
+	SceneQuery* GetQuery();
+	SceneQuery* RegisterQuery(uint32_t queryId, const ComponentMask& mask, const ComponentMask& excludeMask, const ComponentMask& changedMask, const eastl::string& name);
+
+	// Calls func(EntityID, ComponentTypes*...) for every entity with these components, spread across the job workers
+	// Each archetype chunk is one batch of work, so func gets called on many threads at once,
+	// and must not create or destroy entities, or assign or remove components
+	// Every chunk visited counts as changing all of these components. Other components must only be accessed with Read
+	template <typename... ComponentTypes, typename Func>
+	void ParallelForEach(Func func);
+	Archetype* GetArchetypeWith(Archetype* pArchetype, uint32_t componentId);
+	Archetype* GetArchetypeWithout(Archetype* pArchetype, uint32_t componentId);
+
+	// Raw pointer to the given component of an entity, assumes the entity has it
+	void* GetRaw(EntityIndex index, uint32_t componentId);
+
+	// Chunk memory comes from the scene's own arena, so it's all cache line aligned and freed in one go with the scene
+	// A few idle chunks are kept whole ready for reuse, so their column bookkeeping doesn't need allocating again,
+	// the rest have their pages given back until they're needed again
+	ArchetypeChunk* AllocateChunk(size_t nColumns);
+	void FreeChunk(ArchetypeChunk* pChunk);
+
+	// Total bytes of memory committed for this scene's chunks. The arena commits well ahead of what's used,
+	// so this includes idle chunks and pages no chunk has reached yet
+	size_t GetResidentBytes();
+
+	// Captures every entity and component so the scene can be put back exactly as it was later
+	// Columns that haven't changed since the last snapshot or restore are shared rather than copied,
+	// so taking snapshots every frame only pays for what changed. Changes are found through the
+	// change versions, so components written through pointers held from before the snapshot aren't noticed
+	SceneSnapshot Snapshot();
+
+	// Puts the scene back to the snapshot. No reactive systems are called, queued reactive events
+	// are dropped, and entities made since the snapshot are gone. Snapshots must not outlive their scene
+	void Restore(const SceneSnapshot& snapshot);
+
 	void SetParent(EntityID child, EntityID parent);
 
 	void UnsetParent(EntityID child, EntityID parent);
 
-	void RegisterSystem(SystemPhase phase, SystemFunc func);
+	void RegisterSystem(SystemPhase phase, SystemFunc func, const SystemAccess& access = SystemAccess());
 
 	void SimulateScene(float deltaTime);
 
 	void RenderScene(float deltaTime);
 
 	eastl::vector<ComponentPool*> componentPools;
+	eastl::vector<Archetype*> archetypes;
+	eastl::vector<Archetype*> noArchetypes; // Given to queries for components that were never used
+	eastl::vector<SceneQuery*> queries; // Indexed by query id, may have gaps
 
 	int nActiveEntities{0};
 	eastl::vector<EntityDesc> entities;
 	eastl::vector<EntityIndex> freeEntities; // We just store the indices here, not a full EntityID
 
-	eastl::vector<SystemFunc> preUpdateSystems;
-	eastl::vector<SystemFunc> updateSystems;
-	eastl::vector<SystemFunc> renderSystems;
-};
+	size_t nActiveChunks{0};
+	VirtualArena chunkArena;
+	eastl::vector<ArchetypeChunk*> idleChunks;
+	eastl::vector<char*> decommittedChunks;
 
-struct ComponentPool
-{
-	ComponentPool(size_t elementsize, TypeData& typeData, void (*_pDestructor)(void *, TypeData*));
+	SystemSchedule preUpdateSystems;
+	SystemSchedule updateSystems;
+	SystemSchedule renderSystems;
 
-	~ComponentPool();
+	uint32_t changeVersion{1};
 
-	inline void *GetRaw(size_t index)
-	{
-		ASSERT(index < MAX_ENTITIES, "Entity overrun, delete some entities");
-		return pData + index * elementSize;
-	}
+	// The change version transforms were last updated at
+	uint32_t transformsVersion{0};
+
+	// Guards query creation, as systems running in parallel may ask for new queries
+	SDL_SpinLock queryLock{0};
 
-	inline void Erase(size_t index)
+	// Interned name -> entities, built by FindEntity and kept up to date through the CName change versions
+	// Destroyed or renamed entities are left in until a lookup trips over them
+	eastl::hash_multimap<uint32_t, EntityID> nameIndex;
+	uint32_t nameIndexVersion{0};
+
+	// The batch being handed to reactive systems by FlushReactiveEvents, kept to reuse its memory
+	eastl::vector<EntityID> reactiveEvents;
+
+	// Every entity in a transform hierarchy, sorted by depth so parents always come before their children
+	// Rebuilt by TransformHeirarchy when entities join or leave a hierarchy
+	struct HierarchyNode
 	{
-		pDestructor(GetRaw(index), pTypeData);
-	}
+		EntityID id;
+		int parent; // Index into transformHierarchy, -1 for roots
+
+		// Scratch space for the update pass
+		CTransform* pTransform;
+		bool changed;
+	};
+	eastl::vector<HierarchyNode> transformHierarchy;
+	bool hierarchyChanged{true};
+
+	void RebuildTransformHierarchy();
+
+private:
+	friend struct EntityCommandBuffer;
+
+	// Moves an entity's components into a new archetype, destroying any it doesn't have
+	// Passing nullptr destroys all the entity's components and frees its row
+	void MoveEntity(EntityIndex index, Archetype* pNewArchetype);
+
+	// The part of DestroyEntity after the reactive callbacks have been told
+	void ReleaseEntity(EntityID id);
+};
+
+// Type information and reactive systems for one component type
+// The component data itself lives in archetype chunks, see below
+struct ComponentPool
+{
+	ComponentPool(uint32_t _componentId, size_t elementsize, TypeData& typeData, void (*_pDestructor)(void *, TypeData*), void (*_pMove)(void*, void*, TypeData*));
 
 	void (*pDestructor)(void *, TypeData*);
 
-	char *pData{nullptr};
+	// Move constructs a component into uninitialized memory and destructs the source
+	void (*pMove)(void*, void*, TypeData*);
+
+	uint32_t componentId{0};
 	size_t elementSize{0};
 	TypeData *pTypeData{nullptr};
 
+	// Bytes of chunk memory currently reserved for columns of this component type
+	size_t residentBytes{0};
+
+	// Known only for pools made from the templated functions, lets bulk operations use memcpy
+	bool isTriviallyCopyable{false};
+
+	// The last change version any column of this component changed at, see Scene::AdvanceChangeVersion
+	uint32_t changeVersion{0};
+
+	// Every archetype with this component, and how many entities are in them
+	eastl::vector<Archetype*> archetypes;
+	uint32_t nEntities{0};
+
 	// Systems that have requested to know when this component has been added or removed from an entity
 	eastl::vector<ReactiveSystemFunc> onAddedCallbacks;
 	eastl::vector<ReactiveSystemFunc> onRemovedCallbacks;
+
+	// Batched reactive systems, and the entities waiting for the next Scene::FlushReactiveEvents
+	eastl::vector<ReactiveBatchFunc> onAddedBatchCallbacks;
+	eastl::vector<ReactiveBatchFunc> onRemovedBatchCallbacks;
+	eastl::vector<EntityID> pendingAdded;
+	eastl::vector<EntityID> pendingRemoved;
+
+	bool ReactsToAdd() const { return !onAddedCallbacks.empty() || !onAddedBatchCallbacks.empty(); }
+	bool ReactsToRemove() const { return !onRemovedCallbacks.empty() || !onRemovedBatchCallbacks.empty(); }
+
+	// Calls the immediate reactive systems and queues the entity for the batched ones
+	void OnAdded(Scene& scene, EntityID id);
+	void OnRemoved(Scene& scene, EntityID id);
 };
 
+// A copy of one column of an archetype chunk, immutable once made so snapshots can share it
+// Trivially copyable components are copied with memcpy, anything else through its TypeDataOps
+struct SnapshotColumn
+{
+	SnapshotColumn(ComponentPool* _pPool, void* pSource, uint32_t _count);
+	~SnapshotColumn();
 
-// View into the Scene for a given set of components
+	// Copies the components into uninitialized memory
+	void CopyTo(void* pDestination) const;
+
+	ComponentPool* pPool{nullptr};
+	uint32_t count{0};
+	char* pData{nullptr};
+};
+
+// A fixed size, aligned block of memory holding the components of up to
+// chunkCapacity entities of one archetype, stored as one packed column per component
+// Chunks are never resized, so the scene can grow without moving existing component data
+struct ArchetypeChunk
+{
+	char* pData{nullptr};
+	uint32_t count{0};
+
+	// Change version of each column, see Scene::AdvanceChangeVersion
+	eastl::vector<uint32_t> columnVersions;
+
+	// The last snapshot taken or restored of each column, and the column's version at the time
+	// The next snapshot shares it if the column hasn't changed since
+	eastl::vector<eastl::shared_ptr<SnapshotColumn>> snapshotColumns;
+	eastl::vector<uint32_t> snapshotVersions;
+};
+
+// All entities with exactly the same component mask live together in one archetype
+struct Archetype
+{
+	Archetype(Scene& scene, const ComponentMask& _mask);
+	~Archetype();
+
+	// Column index of the given component type, or -1 if this archetype doesn't have it
+	inline int GetColumn(uint32_t componentId) const
+	{
+		return componentId < columnLookup.size() ? columnLookup[componentId] : -1;
+	}
+
+	inline EntityID* GetEntities(ArchetypeChunk* pChunk) const
+	{
+		return reinterpret_cast<EntityID*>(pChunk->pData);
+	}
+
+	inline void* GetComponent(ArchetypeChunk* pChunk, int column, uint32_t row) const
+	{
+		return pChunk->pData + columnOffsets[column] + row * columnPools[column]->elementSize;
+	}
+
+	// Packed array of one component type in a chunk, or nullptr if this archetype doesn't have it
+	template<typename T>
+	inline T* GetArray(ArchetypeChunk* pChunk) const
+	{
+		int column = GetColumn(Component::Index<T>());
+		return column >= 0 ? reinterpret_cast<T*>(pChunk->pData + columnOffsets[column]) : nullptr;
+	}
+
+	inline void MarkChanged(ArchetypeChunk* pChunk, int column) const
+	{
+		pChunk->columnVersions[column] = pScene->changeVersion;
+		columnPools[column]->changeVersion = pScene->changeVersion;
+	}
+
+	// True if any of the given components in this chunk changed after the given version, or if none are given
+	bool ChangedSince(ArchetypeChunk* pChunk, const ComponentMask& componentMask, uint32_t version) const;
+
+	// Adds an empty chunk to the end of the archetype
+	ArchetypeChunk* NewChunk();
+
+	// Appends a row for this entity to the last chunk, making a new chunk if it's full
+	void AllocateRow(EntityID id, uint32_t& outChunk, uint32_t& outRow);
+
+	// Appends up to count rows to the last chunk, making a new chunk if it's full
+	// Returns how many rows were actually allocated, their entity ids are left for you to fill in
+	uint32_t AllocateRows(uint32_t count, uint32_t& outChunk, uint32_t& outFirstRow);
+
+	void FreeChunk(ArchetypeChunk* pChunk);
+
+	Scene* pScene{nullptr};
+	ComponentMask mask;
+	eastl::vector<uint32_t> componentIds;
+	eastl::vector<ComponentPool*> columnPools;
+	eastl::vector<size_t> columnOffsets;
+	eastl::vector<int> columnLookup; // component id -> column index
+
+	uint32_t chunkCapacity{0};
+	uint32_t nEntities{0};
+
+	// Every chunk except the last one is always full
+	eastl::vector<ArchetypeChunk*> chunks;
+
+	// Cached transitions to the archetype with a component added or removed
+	eastl::map<uint32_t, Archetype*> addEdges;
+	eastl::map<uint32_t, Archetype*> removeEdges;
+};
+
+// The whole state of a scene's entities and components at one moment, see Scene::Snapshot
+struct SceneSnapshot
+{
+	struct ChunkState
+	{
+		uint32_t count;
+		eastl::vector<EntityID> entities;
+		eastl::vector<eastl::shared_ptr<SnapshotColumn>> columns;
+	};
+
+	// Archetypes are never destroyed, so these line up with the scene's archetypes list
+	struct ArchetypeState
+	{
+		Archetype* pArchetype;
+		eastl::vector<ChunkState> chunks;
+	};
+
+	Scene* pScene{nullptr};
+	int nActiveEntities{0};
+	eastl::vector<Scene::EntityDesc> entities;
+	eastl::vector<EntityIndex> freeEntities;
+	eastl::vector<uint32_t> poolEntityCounts; // Indexed by component id
+	eastl::vector<ArchetypeState> archetypes;
+};
+
+// A query registered with the scene, holding every archetype that matches its mask
+// The list is kept up to date as new archetypes get made, and since each archetype's
+// chunks are the packed list of its entities, assigning and removing components needs no extra work
+struct SceneQuery
+{
+	// Every distinct set of query components gets an id, shared by all scenes
+	static uint32_t NewQueryId();
+
+	inline bool Matches(const ComponentMask& archetypeMask) const
+	{
+		return MaskContains(archetypeMask, mask) && !MaskIntersects(archetypeMask, excludeMask);
+	}
+
+	// Stats
+	uint32_t CountEntities() const;
+	double GetMaintenanceMs() const;
+
+	ComponentMask mask;
+	ComponentMask excludeMask;
+	ComponentMask changedMask; // Components with a Changed<...> term, checked per chunk while iterating
+	eastl::string name;
+	eastl::vector<Archetype*> archetypes;
+
+	uint32_t nArchetypeTests{0};
+	uint64_t maintenanceTicks{0};
+};
+
+// Query terms, for use in SceneIterator, SceneChunkIterator and GetQuery
+// Without<...> skips entities that have any of the given components
+// Optional<...> doesn't change which entities match, but lets you ask for the component when it's there
+// Changed<...> requires the components, and skips chunks where none of them changed since the version given to the iterator
+// For example SceneChunkIterator<CTransform, Without<CChild>, Optional<CParent>>
 template <typename... ComponentTypes>
-struct SceneIterator
+struct Without {};
+
+template <typename... ComponentTypes>
+struct Optional {};
+
+template <typename... ComponentTypes>
+struct Changed {};
+
+// Adds one term of a query to its masks and name
+template <typename T>
+struct QueryTerm
 {
-	template <size_t comps = sizeof...(ComponentTypes), eastl::enable_if_t<comps == 0, int> = 0>
-	SceneIterator(Scene &scene) : pScene(&scene)
+	static void Add(ComponentMask& mask, ComponentMask& excludeMask, ComponentMask& changedMask, eastl::string& name)
 	{
-		all = true;
+		mask.set(Component::Index<T>());
+		name.append_sprintf(name.empty() ? "%s" : ", %s", TypeDatabase::Get<T>().name);
 	}
+};
 
-	template <size_t comps = sizeof...(ComponentTypes), eastl::enable_if_t<comps != 0, int> = 0>
-	SceneIterator(Scene &scene) : pScene(&scene)
+template <typename... ComponentTypes>
+struct QueryTerm<Without<ComponentTypes...>>
+{
+	static void Add(ComponentMask& mask, ComponentMask& excludeMask, ComponentMask& changedMask, eastl::string& name)
 	{
-		uint32_t componentIndexes[] = {0, Type::Index<ComponentTypes>()...};
-		for (int i = 1; i < (sizeof...(ComponentTypes) + 1); i++)
-			componentMask.set(componentIndexes[i]);
+		uint32_t componentIds[] = {0, Component::Index<ComponentTypes>()...};
+		const char* componentNames[] = {"", TypeDatabase::Get<ComponentTypes>().name...};
+		for (size_t i = 1; i <= sizeof...(ComponentTypes); i++)
+		{
+			excludeMask.set(componentIds[i]);
+			name.append_sprintf(name.empty() ? "!%s" : ", !%s", componentNames[i]);
+		}
+	}
+};
+
+template <typename... ComponentTypes>
+struct QueryTerm<Changed<ComponentTypes...>>
+{
+	static void Add(ComponentMask& mask, ComponentMask& excludeMask, ComponentMask& changedMask, eastl::string& name)
+	{
+		uint32_t componentIds[] = {0, Component::Index<ComponentTypes>()...};
+		const char* componentNames[] = {"", TypeDatabase::Get<ComponentTypes>().name...};
+		for (size_t i = 1; i <= sizeof...(ComponentTypes); i++)
+		{
+			mask.set(componentIds[i]);
+			changedMask.set(componentIds[i]);
+			name.append_sprintf(name.empty() ? "~%s" : ", ~%s", componentNames[i]);
+		}
+	}
+};
+
+template <typename... ComponentTypes>
+struct QueryTerm<Optional<ComponentTypes...>>
+{
+	static void Add(ComponentMask& mask, ComponentMask& excludeMask, ComponentMask& changedMask, eastl::string& name)
+	{
+		const char* componentNames[] = {"", TypeDatabase::Get<ComponentTypes>().name...};
+		for (size_t i = 1; i <= sizeof...(ComponentTypes); i++)
+		{
+			name.append_sprintf(name.empty() ? "?%s" : ", ?%s", componentNames[i]);
+		}
+	}
+};
+
+// View into the Scene for a given set of components
+// Walks the chunks of every archetype that has these components, in storage order
+// The matching archetypes come from a SceneQuery cached in the scene, so no searching is done here
+// Give a change version if the query has Changed<...> terms
+template <typename... ComponentTypes>
+struct SceneIterator
+{
+	SceneIterator(Scene &scene, uint32_t changedSince = 0) : pScene(&scene), changedSince(changedSince)
+	{
+		pQuery = scene.GetQuery<ComponentTypes...>();
 	}
 
 	struct Iterator
 	{
-		Iterator(Scene *pScene, EntityIndex index, ComponentMask mask, bool all) : pScene(pScene), index(index), mask(mask), all(all) {}
+		Iterator(const SceneQuery* pQuery, size_t archetype, uint32_t changedSince) : pQuery(pQuery), archetype(archetype), changedSince(changedSince) {}
 
-		EntityID operator*() const { return pScene->entities[index].id; }
+		EntityID operator*() const 
+		{
+			Archetype* pArchetype = pQuery->archetypes[archetype];
+			return pArchetype->GetEntities(pArchetype->chunks[chunk])[row];
+		}
 		bool operator==(const Iterator &other) const
 		{
-			return index == other.index || index == pScene->entities.size();
+			if (AtEnd() || other.AtEnd())
+				return AtEnd() == other.AtEnd();
+			return archetype == other.archetype && chunk == other.chunk && row == other.row;
 		}
 		bool operator!=(const Iterator &other) const
 		{
-			return index != other.index && index != pScene->entities.size();
+			return !(*this == other);
 		}
 
-		bool ValidIndex()
+		bool AtEnd() const
 		{
-			return
-				// It's a valid entity ID
-				pScene->entities[index].id.IsValid() &&
-				// It has the correct component mask
-				(all || mask == (mask & pScene->entities[index].mask));
+			return archetype >= pQuery->archetypes.size();
 		}
 
-		Iterator &operator++()
+		// Moves forward until we're pointing at a live row, or the end
+		void SkipToValid()
 		{
-			do
+			while (!AtEnd())
 			{
-				index++;
-			} while (index < pScene->entities.size() && !ValidIndex());
+				Archetype* pArchetype = pQuery->archetypes[archetype];
+				while (chunk < pArchetype->chunks.size())
+				{
+					// Only need to check for changes as we enter a chunk
+					ArchetypeChunk* pChunk = pArchetype->chunks[chunk];
+					if (row < pChunk->count && (row > 0 || pArchetype->ChangedSince(pChunk, pQuery->changedMask, changedSince)))
+						return;
+					chunk++;
+					row = 0;
+				}
+				archetype++;
+				chunk = 0;
+				row = 0;
+			}
+		}
+
+		Iterator &operator++()
+		{
+			row++;
+			SkipToValid();
 			return *this;
 		}
 
-		EntityIndex index;
-		Scene *pScene;
-		ComponentMask mask;
-		bool all{false};
+		const SceneQuery* pQuery;
+		size_t archetype{0};
+		uint32_t chunk{0};
+		uint32_t row{0};
+		uint32_t changedSince{0};
 	};
 
 	const Iterator begin() const
 	{
-		int firstIndex = 0;
-		while (firstIndex < pScene->entities.size() &&								 // Checking we're not overflowing
-			   (componentMask != (componentMask & pScene->entities[firstIndex].mask) // Does this index have the right components?
-				|| !pScene->entities[firstIndex].id.IsValid()))						 // Does this index have a valid entity?
+		Iterator it(pQuery, 0, changedSince);
+		it.SkipToValid();
+		return it;
+	}
+
+	const Iterator end() const
+	{
+		return Iterator(pQuery, size_t(-1), changedSince);
+	}
+
+	Scene *pScene{nullptr};
+	const SceneQuery* pQuery{nullptr};
+	uint32_t changedSince{0};
+};
+
+// One chunk of packed components, as given out by SceneChunkIterator
+struct SceneChunk
+{
+	// Returns nullptr for Optional components this chunk doesn't have
+	// This counts as changing the components, use Read if you're not going to
+	template<typename T>
+	T* Get() const 
+	{
+		int column = pArchetype->GetColumn(Component::Index<T>());
+		if (column < 0)
+			return nullptr;
+		pArchetype->MarkChanged(pChunk, column);
+		return pArchetype->GetArray<T>(pChunk);
+	}
+
+	template<typename T>
+	const T* Read() const { return pArchetype->GetArray<T>(pChunk); }
+
+	template<typename T>
+	void MarkChanged() const { pArchetype->MarkChanged(pChunk, pArchetype->GetColumn(Component::Index<T>())); }
+
+	template<typename T>
+	bool Has() const { return pArchetype->mask.test(Component::Index<T>()); }
+
+	EntityID* GetEntities() const { return pArchetype->GetEntities(pChunk); }
+
+	uint32_t Count() const { return pChunk->count; }
+
+	Archetype* pArchetype;
+	ArchetypeChunk* pChunk;
+};
+
+// Chunk level view into the Scene for a given set of components
+// Use this to walk packed component arrays directly like so:
+//
+// for (SceneChunk chunk : SceneChunkIterator<CTransform>(scene))
+// {
+//     CTransform* pTransforms = chunk.Get<CTransform>();
+//     for (uint32_t i = 0; i < chunk.Count(); i++)
+//         pTransforms[i]...
+// }
+//
+template <typename... ComponentTypes>
+struct SceneChunkIterator
+{
+	SceneChunkIterator(Scene &scene, uint32_t changedSince = 0) : pScene(&scene), changedSince(changedSince)
+	{
+		pQuery = scene.GetQuery<ComponentTypes...>();
+	}
+
+	struct Iterator
+	{
+		Iterator(const SceneQuery* pQuery, size_t archetype, uint32_t changedSince) : pQuery(pQuery), archetype(archetype), changedSince(changedSince) {}
+
+		SceneChunk operator*() const 
+		{
+			Archetype* pArchetype = pQuery->archetypes[archetype];
+			return SceneChunk{ pArchetype, pArchetype->chunks[chunk] };
+		}
+		bool operator==(const Iterator &other) const
+		{
+			if (AtEnd() || other.AtEnd())
+				return AtEnd() == other.AtEnd();
+			return archetype == other.archetype && chunk == other.chunk;
+		}
+		bool operator!=(const Iterator &other) const
+		{
+			return !(*this == other);
+		}
+
+		bool AtEnd() const
 		{
-			firstIndex++;
+			return archetype >= pQuery->archetypes.size();
 		}
-		return Iterator(pScene, firstIndex, componentMask, all);
+
+		void SkipToValid()
+		{
+			while (!AtEnd())
+			{
+				Archetype* pArchetype = pQuery->archetypes[archetype];
+				while (chunk < pArchetype->chunks.size())
+				{
+					if (pArchetype->ChangedSince(pArchetype->chunks[chunk], pQuery->changedMask, changedSince))
+						return;
+					chunk++;
+				}
+				archetype++;
+				chunk = 0;
+			}
+		}
+
+		Iterator &operator++()
+		{
+			chunk++;
+			SkipToValid();
+			return *this;
+		}
+
+		const SceneQuery* pQuery;
+		size_t archetype{0};
+		uint32_t chunk{0};
+		uint32_t changedSince{0};
+	};
+
+	const Iterator begin() const
+	{
+		Iterator it(pQuery, 0, changedSince);
+		it.SkipToValid();
+		return it;
 	}
 
 	const Iterator end() const
 	{
-		return Iterator(pScene, EntityIndex(pScene->entities.size()), componentMask, all);
+		return Iterator(pQuery, size_t(-1), changedSince);
 	}
 
 	Scene *pScene{nullptr};
-	ComponentMask componentMask;
-	bool all{false};
+	const SceneQuery* pQuery{nullptr};
+	uint32_t changedSince{0};
 };
 
 struct ComponentsOnEntity
@@ -414,24 +1063,197 @@ struct ComponentsOnEntity
 // ------------INTERNAL---------------
 // -----------------------------------
 
+inline bool MaskContains(const ComponentMask& mask, const ComponentMask& subset)
+{
+	const uint64_t* pMask = mask.data();
+	const uint64_t* pSubset = subset.data();
+#ifdef ATHENA_MASK_SSE2
+	__m128i missing = _mm_setzero_si128();
+	for (int i = 0; i < COMPONENT_MASK_WORDS; i += 2)
+	{
+		__m128i maskWords = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pMask + i));
+		__m128i subsetWords = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSubset + i));
+		missing = _mm_or_si128(missing, _mm_andnot_si128(maskWords, subsetWords));
+	}
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(missing, _mm_setzero_si128())) == 0xFFFF;
+#else
+	uint64_t missing = 0;
+	for (int i = 0; i < COMPONENT_MASK_WORDS; i++)
+		missing |= pSubset[i] & ~pMask[i];
+	return missing == 0;
+#endif
+}
+
+// ***********************************************************************
+
+inline bool MaskIntersects(const ComponentMask& a, const ComponentMask& b)
+{
+	const uint64_t* pA = a.data();
+	const uint64_t* pB = b.data();
+#ifdef ATHENA_MASK_SSE2
+	__m128i shared = _mm_setzero_si128();
+	for (int i = 0; i < COMPONENT_MASK_WORDS; i += 2)
+	{
+		__m128i aWords = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pA + i));
+		__m128i bWords = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pB + i));
+		shared = _mm_or_si128(shared, _mm_and_si128(aWords, bWords));
+	}
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(shared, _mm_setzero_si128())) != 0xFFFF;
+#else
+	uint64_t shared = 0;
+	for (int i = 0; i < COMPONENT_MASK_WORDS; i++)
+		shared |= pA[i] & pB[i];
+	return shared != 0;
+#endif
+}
+
+// ***********************************************************************
+
+inline bool MaskEquals(const ComponentMask& a, const ComponentMask& b)
+{
+	const uint64_t* pA = a.data();
+	const uint64_t* pB = b.data();
+#ifdef ATHENA_MASK_SSE2
+	__m128i different = _mm_setzero_si128();
+	for (int i = 0; i < COMPONENT_MASK_WORDS; i += 2)
+	{
+		__m128i aWords = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pA + i));
+		__m128i bWords = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pB + i));
+		different = _mm_or_si128(different, _mm_xor_si128(aWords, bWords));
+	}
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(different, _mm_setzero_si128())) == 0xFFFF;
+#else
+	uint64_t different = 0;
+	for (int i = 0; i < COMPONENT_MASK_WORDS; i++)
+		different |= pA[i] ^ pB[i];
+	return different == 0;
+#endif
+}
+
+// ***********************************************************************
+
 template <typename T>
 ComponentPool* Scene::GetOrCreateComponentPool()
 {
-	uint32_t componentId = Type::Index<T>();
+	uint32_t componentId = Component::Index<T>();
 	if (componentPools.size() <= componentId) // Not enough component pool
 		componentPools.resize(componentId + 1, nullptr);
 
 	if (componentPools[componentId] == nullptr) // New component, make a new pool
 	{
-		componentPools[componentId] = new ComponentPool(sizeof(T), TypeDatabase::Get<T>(), [](void *pComponent, TypeData* pTypeData) {
+		componentPools[componentId] = new ComponentPool(componentId, sizeof(T), TypeDatabase::Get<T>(), [](void *pComponent, TypeData* pTypeData) {
 			static_cast<T *>(pComponent)->~T();
+		}, [](void* pDestination, void* pSource, TypeData* pTypeData) {
+			new (pDestination) T(eastl::move(*static_cast<T *>(pSource)));
+			static_cast<T *>(pSource)->~T();
 		});
+		componentPools[componentId]->isTriviallyCopyable = std::is_trivially_copyable<T>::value;
 	}
 	return componentPools[componentId];
 }
 
 // ***********************************************************************
 
+template <typename... ComponentTypes>
+SceneQuery* Scene::GetQuery()
+{
+	static uint32_t queryId = SceneQuery::NewQueryId();
+
+	SDL_AtomicLock(&queryLock);
+	SceneQuery* pQuery = queryId < queries.size() ? queries[queryId] : nullptr;
+	if (pQuery == nullptr)
+	{
+		ComponentMask mask;
+		ComponentMask excludeMask;
+		ComponentMask changedMask;
+		eastl::string name;
+		int terms[] = {0, (QueryTerm<ComponentTypes>::Add(mask, excludeMask, changedMask, name), 0)...};
+		(void)terms;
+		pQuery = RegisterQuery(queryId, mask, excludeMask, changedMask, name);
+	}
+	SDL_AtomicUnlock(&queryLock);
+	return pQuery;
+}
+
+// ***********************************************************************
+
+template <typename... ComponentTypes>
+void Scene::NewEntities(uint32_t count, EntityID* pOutIds)
+{
+	ComponentPool* pools[] = {nullptr, GetOrCreateComponentPool<ComponentTypes>()...};
+	(void)pools;
+
+	ComponentMask mask;
+	uint32_t componentIds[] = {0, Component::Index<ComponentTypes>()...};
+	for (size_t i = 1; i <= sizeof...(ComponentTypes); i++)
+		mask.set(componentIds[i]);
+
+	NewEntities(count, mask, pOutIds);
+}
+
+// ***********************************************************************
+
+namespace SceneInternal
+{
+	template <typename Func, typename... ComponentTypes>
+	void ForEachInChunk(Func& func, EntityID* pEntities, uint32_t count, ComponentTypes*... pArrays)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			func(pEntities[i], &pArrays[i]...);
+		}
+	}
+
+	template <typename Func, typename... ComponentTypes>
+	struct ForEachBatch
+	{
+		static void Run(void* pData)
+		{
+			// The chunk was already stamped as changed when the batch was made, see ParallelForEach
+			ForEachBatch* pBatch = static_cast<ForEachBatch*>(pData);
+			SceneChunk& chunk = pBatch->chunk;
+			ForEachInChunk(*pBatch->pFunc, chunk.GetEntities(), chunk.Count(), chunk.pArchetype->GetArray<ComponentTypes>(chunk.pChunk)...);
+		}
+
+		Func* pFunc;
+		SceneChunk chunk;
+	};
+}
+
+template <typename... ComponentTypes, typename Func>
+void Scene::ParallelForEach(Func func)
+{
+	typedef SceneInternal::ForEachBatch<Func, ComponentTypes...> Batch;
+
+	// Change versions are stamped here rather than from the workers, which would all be writing the same pool versions
+	eastl::vector<Batch> batches;
+	for (SceneChunk chunk : SceneChunkIterator<ComponentTypes...>(*this))
+	{
+		int stamped[] = {0, (chunk.MarkChanged<ComponentTypes>(), 0)...};
+		(void)stamped;
+		batches.push_back(Batch{ &func, chunk });
+	}
+
+	// Not worth the overhead of the queue
+	if (batches.size() < 2 || Jobs::GetWorkerCount() == 0)
+	{
+		for (Batch& batch : batches)
+		{
+			Batch::Run(&batch);
+		}
+		return;
+	}
+
+	Jobs::Counter counter;
+	for (Batch& batch : batches)
+	{
+		Jobs::Run(Batch::Run, &batch, &counter);
+	}
+	Jobs::Wait(&counter);
+}
+
+// ***********************************************************************
+
 template <typename T>
 void Scene::RegisterReactiveSystem(Reaction reaction, ReactiveSystemFunc func)
 {
@@ -452,6 +1274,26 @@ void Scene::RegisterReactiveSystem(Reaction reaction, ReactiveSystemFunc func)
 
 // ***********************************************************************
 
+template <typename T>
+void Scene::RegisterReactiveSystem(Reaction reaction, ReactiveBatchFunc func)
+{
+	ComponentPool *pPool = GetOrCreateComponentPool<T>();
+
+	switch (reaction)
+	{
+	case Reaction::OnAdd:
+		pPool->onAddedBatchCallbacks.push_back(func);
+		break;
+	case Reaction::OnRemove:
+		pPool->onRemovedBatchCallbacks.push_back(func);
+		break;
+	default:
+		break;
+	}
+}
+
+// ***********************************************************************
+
 template <typename T>
 T* Scene::Assign(EntityID id)
 {
@@ -461,15 +1303,15 @@ T* Scene::Assign(EntityID id)
 	ComponentPool *pPool = GetOrCreateComponentPool<T>();
 	ASSERT(Has<T>(id) == false, "You're trying to assign a component to an entity that already has this component");
 
-	T *pComponent = new (pPool->GetRaw(id.Index())) T();
+	uint32_t componentId = Component::Index<T>();
+	EntityDesc& desc = entities[id.Index()];
 
-	int componentId = Type::Index<T>();
-	entities[id.Index()].mask.set(componentId);
+	MoveEntity(id.Index(), GetArchetypeWith(desc.pArchetype, componentId));
 
-	for (ReactiveSystemFunc func : pPool->onAddedCallbacks)
-	{
-		func(*this, id);
-	}
+	T *pComponent = new (GetRaw(id.Index(), componentId)) T();
+	pPool->nEntities++;
+
+	pPool->OnAdded(*this, id);
 
 	return pComponent;
 }
@@ -482,15 +1324,15 @@ void Scene::Remove(EntityID id)
 	if (entities[id.Index()].id != id) 
 		return;
 
-	int componentId = Type::Index<T>();
+	uint32_t componentId = Component::Index<T>();
 	ASSERT(Has<T>(id), "The component you're trying to access is not assigned to this entity");
 
-	for (ReactiveSystemFunc func : componentPools[componentId]->onRemovedCallbacks)
-	{
-		func(*this, id);
-	}
-	entities[id.Index()].mask.reset(componentId);
-	componentPools[componentId]->Erase(id.Index());
+	ComponentPool* pPool = componentPools[componentId];
+	pPool->OnRemoved(*this, id);
+
+	EntityDesc& desc = entities[id.Index()];
+	pPool->nEntities--;
+	MoveEntity(id.Index(), GetArchetypeWithout(desc.pArchetype, componentId)); // Destructs the removed component
 }
 
 // ***********************************************************************
@@ -501,20 +1343,81 @@ T* Scene::Get(EntityID id) // #TODO: Move implementation to lower down in the fi
 	if (entities[id.Index()].id != id) // ensures you're not accessing an entity that has been deleted
 		return nullptr;
 
-	int componentId = Type::Index<T>();
-
 	ASSERT(Has<T>(id), "The component you're trying to access is not assigned to this entity");
-	T *pComponent = static_cast<T *>(componentPools[componentId]->GetRaw(id.Index()));
+	MarkChanged<T>(id);
+	T *pComponent = static_cast<T *>(GetRaw(id.Index(), Component::Index<T>()));
 	return pComponent;
 }
 
 // ***********************************************************************
 
+template <typename T>
+T* Scene::TryGet(EntityID id)
+{
+	if (!id.IsValid() || entities[id.Index()].id != id)
+		return nullptr;
+
+	EntityDesc& desc = entities[id.Index()];
+	int column = desc.pArchetype->GetColumn(Component::Index<T>());
+	if (column < 0)
+		return nullptr;
+	ArchetypeChunk* pChunk = desc.pArchetype->chunks[desc.chunk];
+	desc.pArchetype->MarkChanged(pChunk, column);
+	return static_cast<T *>(desc.pArchetype->GetComponent(pChunk, column, desc.row));
+}
+
+// ***********************************************************************
+
+template <typename T>
+const T* Scene::Read(EntityID id)
+{
+	if (entities[id.Index()].id != id)
+		return nullptr;
+
+	ASSERT(Has<T>(id), "The component you're trying to access is not assigned to this entity");
+	return static_cast<const T *>(GetRaw(id.Index(), Component::Index<T>()));
+}
+
+// ***********************************************************************
+
+template <typename T>
+const T* Scene::TryRead(EntityID id)
+{
+	if (!id.IsValid() || entities[id.Index()].id != id)
+		return nullptr;
+
+	EntityDesc& desc = entities[id.Index()];
+	int column = desc.pArchetype->GetColumn(Component::Index<T>());
+	if (column < 0)
+		return nullptr;
+	return static_cast<const T *>(desc.pArchetype->GetComponent(desc.pArchetype->chunks[desc.chunk], column, desc.row));
+}
+
+// ***********************************************************************
+
+template <typename T>
+void Scene::MarkChanged(EntityID id)
+{
+	EntityDesc& desc = entities[id.Index()];
+	desc.pArchetype->MarkChanged(desc.pArchetype->chunks[desc.chunk], desc.pArchetype->GetColumn(Component::Index<T>()));
+}
+
+// ***********************************************************************
+
 template <typename T>
 bool Scene::Has(EntityID id)
 {
 	if (!id.IsValid() || entities[id.Index()].id != id) // ensures you're not accessing an entity that has been deleted
 		return false;
 
-	return entities[id.Index()].mask.test(Type::Index<T>());
+	return entities[id.Index()].pArchetype->mask.test(Component::Index<T>());
+}
+
+// ***********************************************************************
+
+inline void* Scene::GetRaw(EntityIndex index, uint32_t componentId)
+{
+	EntityDesc& desc = entities[index];
+	Archetype* pArchetype = desc.pArchetype;
+	return pArchetype->GetComponent(pArchetype->chunks[desc.chunk], pArchetype->GetColumn(componentId), desc.row);
 }
\ No newline at end of file
@@ -1,13 +1,237 @@
 #include "SceneSerializer.h"
 
+#include "AssetDatabase.h"
+#include "StringHash.h"
+
+#include <string.h>
+
+namespace
+{
+    const uint32_t BINARY_SCENE_MAGIC = 0x4e435341; // "ASCN"
+    const uint32_t BINARY_SCENE_VERSION = 2;
+
+    // Set in the type table for components stored as raw memory rather than member by member
+    const uint8_t BINARY_TYPE_RAW = 0x01;
+
+    struct BinaryWriter
+    {
+        template<typename T>
+        void Write(const T& value)
+        {
+            data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void WriteBytes(const void* pBytes, size_t size)
+        {
+            data.append(static_cast<const char*>(pBytes), size);
+        }
+
+        void WriteString(const eastl::string& string)
+        {
+            Write(uint32_t(string.size()));
+            WriteBytes(string.data(), string.size());
+        }
+
+        // Overwrites a value written earlier, for sizes that aren't known until after the data
+        void Patch(size_t offset, uint32_t value)
+        {
+            memcpy(&data[offset], &value, sizeof(value));
+        }
+
+        eastl::string data;
+    };
+
+    struct BinaryReader
+    {
+        BinaryReader(const char* _pData, size_t _size) : pData(_pData), size(_size) {}
+
+        // Returns nullptr and marks the reader as failed if there isn't enough data left
+        const char* ReadBytes(size_t count)
+        {
+            if (failed || count > size - offset)
+            {
+                failed = true;
+                return nullptr;
+            }
+            const char* pBytes = pData + offset;
+            offset += count;
+            return pBytes;
+        }
+
+        template<typename T>
+        T Read()
+        {
+            T value{};
+            if (const char* pBytes = ReadBytes(sizeof(T)))
+                memcpy(&value, pBytes, sizeof(T));
+            return value;
+        }
+
+        eastl::string ReadString()
+        {
+            uint32_t length = Read<uint32_t>();
+            const char* pBytes = ReadBytes(length);
+            return pBytes ? eastl::string(pBytes, length) : eastl::string();
+        }
+
+        size_t Remaining() const
+        {
+            return size - offset;
+        }
+
+        const char* pData;
+        size_t size;
+        size_t offset{0};
+        bool failed{false};
+    };
+
+    struct BinaryType
+    {
+        TypeData* pType; // nullptr if this type doesn't exist anymore, or its layout has changed
+        uint32_t size;
+        uint8_t flags;
+    };
+
+    // ***********************************************************************
+
+    // Types that hold more than their raw bytes, and need writing specially
+    bool IsEntityID(TypeData& type) { return type.id == Type::Index<EntityID>(); }
+    bool IsString(TypeData& type) { return type.id == Type::Index<eastl::string>(); }
+    bool IsAssetHandle(TypeData& type) { return type.id == Type::Index<AssetHandle>(); }
+    bool IsInternedString(TypeData& type) { return type.id == Type::Index<InternedString>(); }
+
+    // ***********************************************************************
+
+    // Saved with each type, so a file written before the type's members changed isn't loaded as garbage
+    uint32_t LayoutHash(TypeData& type, uint32_t hash = 0x811C9DC5)
+    {
+        hash = Fnv1a::Hash(type.name, hash);
+        hash = (hash ^ uint32_t(type.size)) * 0x01000193;
+        if (type.castableTo != TypeData::Struct)
+            return hash;
+
+        TypeData_Struct& structType = type.AsStruct();
+        if (structType.pParentType)
+            hash = LayoutHash(*structType.pParentType, hash);
+        for (const eastl::pair<size_t, Member*>& member : structType.members)
+        {
+            hash = Fnv1a::Hash(member.second->name, hash);
+            hash = (hash ^ uint32_t(member.first)) * 0x01000193;
+            hash = LayoutHash(member.second->GetType(), hash);
+        }
+        return hash;
+    }
+
+    // ***********************************************************************
+
+    // Entity references are saved as indices and interned strings as text, so they can't be copied as raw memory
+    bool ContainsIds(TypeData& type)
+    {
+        if (IsEntityID(type) || IsInternedString(type))
+            return true;
+        if (type.castableTo != TypeData::Struct)
+            return false;
+
+        TypeData_Struct& structType = type.AsStruct();
+        if (structType.pParentType && ContainsIds(*structType.pParentType))
+            return true;
+        for (const eastl::pair<size_t, Member*>& member : structType.members)
+        {
+            if (ContainsIds(member.second->GetType()))
+                return true;
+        }
+        return false;
+    }
+
+    // ***********************************************************************
+
+    void WriteValue(BinaryWriter& writer, TypeData& type, const char* pValue)
+    {
+        if (IsString(type))
+        {
+            writer.WriteString(*reinterpret_cast<const eastl::string*>(pValue));
+        }
+        else if (IsEntityID(type))
+        {
+            const EntityID& id = *reinterpret_cast<const EntityID*>(pValue);
+            writer.Write(id.Index());
+        }
+        else if (IsAssetHandle(type))
+        {
+            writer.WriteString(AssetDB::GetAssetIdentifier(*reinterpret_cast<const AssetHandle*>(pValue)));
+        }
+        else if (IsInternedString(type))
+        {
+            writer.WriteString(reinterpret_cast<const InternedString*>(pValue)->c_str());
+        }
+        else if (type.castableTo == TypeData::Struct)
+        {
+            TypeData_Struct& structType = type.AsStruct();
+            if (structType.pParentType)
+                WriteValue(writer, *structType.pParentType, pValue);
+            for (const eastl::pair<size_t, Member*>& member : structType.members)
+            {
+                WriteValue(writer, member.second->GetType(), pValue + member.first);
+            }
+        }
+        else
+        {
+            writer.WriteBytes(pValue, type.size);
+        }
+    }
+
+    // ***********************************************************************
+
+    void ReadValue(BinaryReader& reader, TypeData& type, char* pValue)
+    {
+        if (IsString(type))
+        {
+            *reinterpret_cast<eastl::string*>(pValue) = reader.ReadString();
+        }
+        else if (IsEntityID(type))
+        {
+            EntityIndex index = reader.Read<EntityIndex>();
+            *reinterpret_cast<EntityID*>(pValue) = index == EntityIndex(-1) ? EntityID::InvalidID() : EntityID::New(index, 0);
+        }
+        else if (IsAssetHandle(type))
+        {
+            *reinterpret_cast<AssetHandle*>(pValue) = AssetHandle(reader.ReadString());
+        }
+        else if (IsInternedString(type))
+        {
+            *reinterpret_cast<InternedString*>(pValue) = InternedString(reader.ReadString().c_str());
+        }
+        else if (type.castableTo == TypeData::Struct)
+        {
+            TypeData_Struct& structType = type.AsStruct();
+            if (structType.pParentType)
+                ReadValue(reader, *structType.pParentType, pValue);
+            for (const eastl::pair<size_t, Member*>& member : structType.members)
+            {
+                ReadValue(reader, member.second->GetType(), pValue + member.first);
+            }
+        }
+        else if (const char* pBytes = reader.ReadBytes(type.size))
+        {
+            memcpy(pValue, pBytes, type.size);
+        }
+    }
+}
+
 // ***********************************************************************
 
 JsonValue SceneSerializer::ToJson(Scene& scene)
 {
     JsonValue json = JsonValue::NewArray();
 
-    for (EntityID entity : SceneIterator<>(scene))
+    // Walk entities in index order rather than storage order, as entity references
+    // are saved as indices and entities get recreated sequentially on load
+    for (Scene::EntityDesc& desc : scene.entities)
 	{
+        if (!desc.id.IsValid())
+            continue;
+
+        EntityID entity = desc.id;
         JsonValue jsonEntity = JsonValue::NewObject();
         for (Variant component : ComponentsOnEntity(scene, entity))
 	    {
@@ -29,9 +253,15 @@ Scene* SceneSerializer::NewSceneFromJson(JsonValue json)
     {
         for (JsonValue& jsonEnt : *json.internalData.pArray)
 		{
-            // For each entity create new entity in scene,
-            eastl::string name = jsonEnt["CName"]["name"].ToString();
-            EntityID entId = pScene->NewEntity(name.c_str());
+            // For each entity create new entity in scene, only giving it a name if it had one
+            eastl::string name;
+            const char* pName = nullptr;
+            if (jsonEnt.HasKey("CName"))
+            {
+                name = jsonEnt["CName"]["name"].ToString();
+                pName = name.c_str();
+            }
+            EntityID entId = pScene->NewEntity(pName);
 
             // loop over array of components, Grabbing the component types and Assigning to entity in the scene
             for (const eastl::pair<eastl::string, JsonValue>& val : *jsonEnt.internalData.pObject)
@@ -49,3 +279,274 @@ Scene* SceneSerializer::NewSceneFromJson(JsonValue json)
     }
     return pScene;
 }
+
+
+// ***********************************************************************
+
+eastl::string SceneSerializer::ToBinary(Scene& scene)
+{
+    BinaryWriter writer;
+
+    // Only the component types actually in use go in the type table
+    eastl::vector<uint32_t> typeIndices(scene.componentPools.size(), 0);
+    eastl::vector<ComponentPool*> usedPools;
+    for (ComponentPool* pPool : scene.componentPools)
+    {
+        if (pPool == nullptr || pPool->nEntities == 0)
+            continue;
+        typeIndices[pPool->componentId] = uint32_t(usedPools.size());
+        usedPools.push_back(pPool);
+    }
+
+    uint32_t nBlocks = 0;
+    for (Archetype* pArchetype : scene.archetypes)
+    {
+        if (pArchetype->nEntities > 0)
+            nBlocks++;
+    }
+
+    writer.Write(BINARY_SCENE_MAGIC);
+    writer.Write(BINARY_SCENE_VERSION);
+    writer.Write(uint32_t(usedPools.size()));
+    writer.Write(uint32_t(scene.entities.size()));
+    writer.Write(nBlocks);
+
+    for (ComponentPool* pPool : usedPools)
+    {
+        TypeData& type = *pPool->pTypeData;
+        uint8_t flags = pPool->isTriviallyCopyable && !ContainsIds(type) ? BINARY_TYPE_RAW : 0;
+        writer.WriteString(type.name);
+        writer.Write(uint32_t(type.size));
+        writer.Write(flags);
+        writer.Write(LayoutHash(type));
+    }
+
+    // The free slots are listed so every slot is accounted for, which lets the loader check the entity count
+    writer.Write(uint32_t(scene.freeEntities.size()));
+    writer.WriteBytes(scene.freeEntities.data(), scene.freeEntities.size() * sizeof(EntityIndex));
+
+    for (Archetype* pArchetype : scene.archetypes)
+    {
+        if (pArchetype->nEntities == 0)
+            continue;
+
+        writer.Write(uint32_t(pArchetype->componentIds.size()));
+        for (uint32_t componentId : pArchetype->componentIds)
+        {
+            writer.Write(typeIndices[componentId]);
+        }
+
+        writer.Write(pArchetype->nEntities);
+        for (ArchetypeChunk* pChunk : pArchetype->chunks)
+        {
+            EntityID* pEntities = pArchetype->GetEntities(pChunk);
+            for (uint32_t row = 0; row < pChunk->count; row++)
+            {
+                writer.Write(pEntities[row].Index());
+            }
+        }
+
+        // Each column is prefixed with its size so unknown types can be skipped on load
+        for (int column = 0; column < (int)pArchetype->componentIds.size(); column++)
+        {
+            ComponentPool* pPool = pArchetype->columnPools[column];
+            bool raw = pPool->isTriviallyCopyable && !ContainsIds(*pPool->pTypeData);
+
+            size_t sizeOffset = writer.data.size();
+            writer.Write(uint32_t(0));
+            for (ArchetypeChunk* pChunk : pArchetype->chunks)
+            {
+                if (raw)
+                {
+                    writer.WriteBytes(pArchetype->GetComponent(pChunk, column, 0), pChunk->count * pPool->elementSize);
+                    continue;
+                }
+                for (uint32_t row = 0; row < pChunk->count; row++)
+                {
+                    WriteValue(writer, *pPool->pTypeData, static_cast<const char*>(pArchetype->GetComponent(pChunk, column, row)));
+                }
+            }
+            writer.Patch(sizeOffset, uint32_t(writer.data.size() - sizeOffset - sizeof(uint32_t)));
+        }
+    }
+    return writer.data;
+}
+
+// ***********************************************************************
+
+bool SceneSerializer::IsBinary(const eastl::string& data)
+{
+    BinaryReader reader(data.data(), data.size());
+    return reader.Read<uint32_t>() == BINARY_SCENE_MAGIC && !reader.failed;
+}
+
+// ***********************************************************************
+
+Scene* SceneSerializer::NewSceneFromBinary(const eastl::string& data)
+{
+    BinaryReader reader(data.data(), data.size());
+    if (reader.Read<uint32_t>() != BINARY_SCENE_MAGIC || reader.Read<uint32_t>() != BINARY_SCENE_VERSION)
+    {
+        Log::Warn("Not a binary scene, or it was saved with a different version of the format");
+        return nullptr;
+    }
+    uint32_t nTypes = reader.Read<uint32_t>();
+    uint32_t nEntities = reader.Read<uint32_t>();
+    uint32_t nBlocks = reader.Read<uint32_t>();
+
+    eastl::vector<BinaryType> types;
+    for (uint32_t i = 0; i < nTypes && !reader.failed; i++)
+    {
+        eastl::string name = reader.ReadString();
+        BinaryType type;
+        type.pType = nullptr;
+        type.size = reader.Read<uint32_t>();
+        type.flags = reader.Read<uint8_t>();
+        uint32_t layoutHash = reader.Read<uint32_t>();
+
+        if (!TypeDatabase::TypeExists(name.c_str()))
+        {
+            Log::Warn("Component type %s in binary scene doesn't exist anymore, it will be skipped", name.c_str());
+        }
+        else if (!ATHENA_ENTITY_NAMES && name == "CName")
+        {
+            // Names are compiled out, quietly drop them
+        }
+        else if (LayoutHash(TypeDatabase::GetFromString(name.c_str())) != layoutHash)
+        {
+            Log::Warn("Component type %s has changed since the binary scene was saved, it will be skipped", name.c_str());
+        }
+        else
+        {
+            type.pType = &TypeDatabase::GetFromString(name.c_str());
+        }
+        types.push_back(type);
+    }
+    uint32_t nFree = reader.Read<uint32_t>();
+    const char* pFreeIndices = reader.ReadBytes(size_t(nFree) * sizeof(EntityIndex));
+    if (reader.failed)
+    {
+        Log::Warn("Binary scene is truncated");
+        return nullptr;
+    }
+
+    // Every slot that isn't free has its index in one of the blocks, so don't allocate more than the rest of the data can claim
+    if (nFree > nEntities || uint64_t(nEntities - nFree) * sizeof(EntityIndex) > reader.Remaining())
+    {
+        Log::Warn("Binary scene is corrupt or truncated");
+        return nullptr;
+    }
+
+    Scene* pScene = new Scene();
+
+    // Every slot starts free, blocks then claim their entities' slots by putting them on the free list
+    // Slots are marked as they're claimed, so no two entities or free list entries can share one
+    pScene->entities.resize(nEntities, Scene::EntityDesc{ EntityID::InvalidID() });
+    eastl::vector<bool> claimed(nEntities, false);
+    eastl::vector<EntityIndex> freeEntities(nFree);
+    for (uint32_t i = 0; i < nFree; i++)
+    {
+        memcpy(&freeEntities[i], pFreeIndices + size_t(i) * sizeof(EntityIndex), sizeof(EntityIndex));
+        if (freeEntities[i] >= nEntities || claimed[freeEntities[i]])
+        {
+            reader.failed = true;
+            break;
+        }
+        claimed[freeEntities[i]] = true;
+    }
+    uint32_t nClaimed = nFree;
+
+    eastl::vector<uint32_t> columnTypes;
+    eastl::vector<EntityID> ids;
+    for (uint32_t block = 0; block < nBlocks && !reader.failed; block++)
+    {
+        ComponentMask mask;
+        columnTypes.resize(reader.Read<uint32_t>());
+        for (uint32_t& typeIndex : columnTypes)
+        {
+            typeIndex = reader.Read<uint32_t>();
+            if (typeIndex >= types.size())
+            {
+                reader.failed = true;
+                break;
+            }
+            if (TypeData* pType = types[typeIndex].pType)
+            {
+                mask.set(pScene->GetOrCreateComponentPool(*pType)->componentId);
+            }
+        }
+
+        uint32_t count = reader.Read<uint32_t>();
+        const char* pIndices = reader.ReadBytes(size_t(count) * sizeof(EntityIndex));
+        if (reader.failed)
+            break;
+
+        pScene->freeEntities.clear();
+        for (uint32_t i = count; i > 0; i--)
+        {
+            EntityIndex index;
+            memcpy(&index, pIndices + (i - 1) * sizeof(EntityIndex), sizeof(EntityIndex));
+            if (index >= nEntities || claimed[index])
+            {
+                reader.failed = true;
+                break;
+            }
+            claimed[index] = true;
+            pScene->freeEntities.push_back(index);
+        }
+        nClaimed += count;
+        if (reader.failed)
+            break;
+
+        ids.resize(count);
+        pScene->NewEntities(count, mask, ids.data());
+
+        for (uint32_t typeIndex : columnTypes)
+        {
+            uint32_t columnSize = reader.Read<uint32_t>();
+            const char* pColumn = reader.ReadBytes(columnSize);
+            const BinaryType& type = types[typeIndex];
+            if (pColumn == nullptr || type.pType == nullptr)
+                continue;
+
+            uint32_t componentId = Component::Index(*type.pType);
+            if (type.flags & BINARY_TYPE_RAW)
+            {
+                if (uint64_t(columnSize) != uint64_t(count) * type.size || type.size != type.pType->size)
+                {
+                    reader.failed = true;
+                    break;
+                }
+
+                // New entities fill their chunks in order, so copy as much as each chunk holds at once
+                for (uint32_t i = 0; i < count;)
+                {
+                    Scene::EntityDesc& desc = pScene->entities[ids[i].Index()];
+                    uint32_t nRows = eastl::min(count - i, desc.pArchetype->chunks[desc.chunk]->count - desc.row);
+                    memcpy(pScene->GetRaw(ids[i].Index(), componentId), pColumn + size_t(i) * type.size, size_t(nRows) * type.size);
+                    i += nRows;
+                }
+            }
+            else
+            {
+                BinaryReader columnReader(pColumn, columnSize);
+                for (uint32_t i = 0; i < count && !columnReader.failed; i++)
+                {
+                    ReadValue(columnReader, *type.pType, static_cast<char*>(pScene->GetRaw(ids[i].Index(), componentId)));
+                }
+                reader.failed = columnReader.failed;
+            }
+        }
+    }
+
+    if (reader.failed || nClaimed != nEntities)
+    {
+        Log::Warn("Binary scene is corrupt or truncated");
+        delete pScene;
+        return nullptr;
+    }
+
+    // Free slots get reused in the same order they would have been in the saved scene
+    pScene->freeEntities.swap(freeEntities);
+    return pScene;
+}
@@ -8,4 +8,14 @@ namespace SceneSerializer
 {
     JsonValue ToJson(Scene& scene);
     Scene* NewSceneFromJson(JsonValue json);
-}
\ No newline at end of file
+
+    // Compact binary format for fast level loading. A table of the component types used comes first,
+    // then one block per archetype holding every component of one type together, so trivially
+    // copyable components load with a memcpy. Entities keep the same indices they had when saved
+    // Files are checked as they're loaded, so corrupt or truncated ones give nullptr rather than a broken scene
+    eastl::string ToBinary(Scene& scene);
+    Scene* NewSceneFromBinary(const eastl::string& data);
+
+    // Checks the header, so you can tell which of the two formats a level file is in
+    bool IsBinary(const eastl::string& data);
+}
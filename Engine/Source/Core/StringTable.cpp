@@ -0,0 +1,149 @@
+#include "StringTable.h"
+
+#include "StringHash.h"
+
+#include <EASTL/vector.h>
+#include <SDL_atomic.h>
+#include <string.h>
+
+namespace
+{
+    // Strings are packed into blocks that are never freed, so pointers to them stay valid
+    const size_t STRING_BLOCK_SIZE = 16 * 1024;
+
+    struct Entry
+    {
+        const char* pString;
+        uint32_t length;
+        uint32_t hash;
+    };
+
+    struct Table
+    {
+        Table()
+        {
+            slots.resize(1024, StringTable::InvalidId);
+            Add("", 0, Fnv1a::Hash("", size_t(0)));
+        }
+
+        // Slot for this string, either the one holding it, or the empty one it should go in
+        uint32_t& FindSlot(const char* string, size_t length, uint32_t hash)
+        {
+            size_t mask = slots.size() - 1;
+            size_t slot = hash & mask;
+            while (true)
+            {
+                uint32_t id = slots[slot];
+                if (id == StringTable::InvalidId)
+                    return slots[slot];
+
+                const Entry& entry = entries[id];
+                if (entry.hash == hash && entry.length == length && memcmp(entry.pString, string, length) == 0)
+                    return slots[slot];
+                slot = (slot + 1) & mask;
+            }
+        }
+
+        uint32_t Add(const char* string, size_t length, uint32_t hash)
+        {
+            char* pCopy;
+            if (length + 1 > STRING_BLOCK_SIZE)
+            {
+                pCopy = new char[length + 1];
+            }
+            else
+            {
+                if (blocks.empty() || blockOffset + length + 1 > STRING_BLOCK_SIZE)
+                {
+                    blocks.push_back(new char[STRING_BLOCK_SIZE]);
+                    blockOffset = 0;
+                }
+                pCopy = blocks.back() + blockOffset;
+                blockOffset += length + 1;
+            }
+            memcpy(pCopy, string, length);
+            pCopy[length] = '\0';
+
+            uint32_t id = uint32_t(entries.size());
+            entries.push_back(Entry{ pCopy, uint32_t(length), hash });
+
+            // Keep the table at most half full so probes stay short
+            if (entries.size() * 2 > slots.size())
+            {
+                size_t newSize = slots.size() * 2;
+                slots.clear();
+                slots.resize(newSize, StringTable::InvalidId);
+                for (uint32_t i = 0; i < uint32_t(entries.size()); i++)
+                {
+                    FindSlot(entries[i].pString, entries[i].length, entries[i].hash) = i;
+                }
+            }
+            else
+            {
+                FindSlot(string, length, hash) = id;
+            }
+            return id;
+        }
+
+        eastl::vector<Entry> entries; // Indexed by id
+        eastl::vector<uint32_t> slots; // Open addressed hash table of ids, size is always a power of two
+        eastl::vector<char*> blocks;
+        size_t blockOffset{ 0 };
+    };
+
+    // Interning can happen from static initializers, so the table is made on first use
+    Table& GetTable()
+    {
+        static Table* pTable = new Table();
+        return *pTable;
+    }
+
+    // Names may be given to entities from job threads
+    SDL_SpinLock tableLock{ 0 };
+}
+
+// ***********************************************************************
+
+uint32_t StringTable::Intern(const char* string)
+{
+    return Intern(string, strlen(string));
+}
+
+// ***********************************************************************
+
+uint32_t StringTable::Intern(const char* string, size_t length)
+{
+    uint32_t hash = Fnv1a::Hash(string, length);
+
+    SDL_AtomicLock(&tableLock);
+    Table& table = GetTable();
+    uint32_t id = table.FindSlot(string, length, hash);
+    if (id == InvalidId)
+        id = table.Add(string, length, hash);
+    SDL_AtomicUnlock(&tableLock);
+    return id;
+}
+
+// ***********************************************************************
+
+uint32_t StringTable::Find(const char* string)
+{
+    size_t length = strlen(string);
+    uint32_t hash = Fnv1a::Hash(string, length);
+
+    SDL_AtomicLock(&tableLock);
+    uint32_t id = GetTable().FindSlot(string, length, hash);
+    SDL_AtomicUnlock(&tableLock);
+    return id;
+}
+
+// ***********************************************************************
+
+const char* StringTable::Get(uint32_t id)
+{
+    SDL_AtomicLock(&tableLock);
+    Table& table = GetTable();
+    const char* pString = id < table.entries.size() ? table.entries[id].pString : "";
+    SDL_AtomicUnlock(&tableLock);
+    return pString;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Global table of interned strings, hashed with Fnv1a
+// Each distinct string is stored once for the lifetime of the program and referred to by a small id,
+// so interned strings are as cheap to copy and compare as ints, and need no allocation of their own.
+// Ids are handed out in the order strings are first seen, so they're not stable between runs, save the text instead
+namespace StringTable
+{
+	const uint32_t InvalidId = 0xFFFFFFFF;
+
+	// Adds the string if it isn't in the table yet. The empty string is always id 0
+	uint32_t Intern(const char* string);
+	uint32_t Intern(const char* string, size_t length);
+
+	// Same as Intern, but doesn't add the string, returning InvalidId if it's not in the table
+	uint32_t Find(const char* string);
+
+	// The string for an id, which stays valid forever
+	const char* Get(uint32_t id);
+}
+
+struct InternedString
+{
+	InternedString() {}
+	InternedString(const char* string) : id(StringTable::Intern(string)) {}
+
+	const char* c_str() const { return StringTable::Get(id); }
+	bool IsEmpty() const { return id == 0; }
+
+	bool operator==(const InternedString& other) const { return id == other.id; }
+	bool operator!=(const InternedString& other) const { return id != other.id; }
+
+	uint32_t id{ 0 };
+};
@@ -431,4 +431,36 @@ TypeData& getPrimitiveTypeData<AssetHandle>()
 {
 	static TypeData_AssetHandle typeData;
 	return typeData;
+}
+
+
+
+
+
+// ***********************************************************************
+
+struct TypeData_InternedString : TypeData
+{
+	TypeData_InternedString() : TypeData{"InternedString", sizeof(InternedString)} 
+	{
+		TypeDatabase::Data::Get().typeNames.emplace("InternedString", this);
+		id = Type::Index<InternedString>();
+	}
+
+	// Saved as plain strings, ids are only meaningful while the program runs
+	virtual JsonValue ToJson(Variant var) override
+	{
+		return JsonValue(var.GetValue<InternedString>().c_str());
+	}
+
+	virtual Variant FromJson(const JsonValue& val) override
+	{
+		return InternedString(val.ToString().c_str());
+	}
+};
+template <>
+TypeData& getPrimitiveTypeData<InternedString>()
+{
+	static TypeData_InternedString typeData;
+	return typeData;
 }
\ No newline at end of file
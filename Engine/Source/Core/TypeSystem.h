@@ -276,7 +276,11 @@ struct Member
  *  Special version of the begin macro for types that are template specializations, such as Vec<float>
  **/
 #define REFLECT_TEMPLATED_BEGIN(ReflectedStruct)\
+	template<>\
+	void ReflectedStruct::initReflection(TypeData_Struct* selfTypeData);\
+	template<>\
 	TypeData_Struct ReflectedStruct::staticTypeData{ReflectedStruct::initReflection};\
+	template<>\
 	TypeData_Struct& ReflectedStruct::GetTypeData() { return ReflectedStruct::staticTypeData; }\
 	template<>\
 	void ReflectedStruct::initReflection(TypeData_Struct* selfTypeData) {\
@@ -405,20 +409,6 @@ namespace TypeDatabase
 	TypeData& Get();
 };
 
-/**
- * Type Index retrieval
- * Note that these indexes are not stable between runs
- * Use like Type::Index<T>()
- **/
-struct Type {
-    template<typename Type>
-    inline static uint32_t Index()
-	{
-		static uint32_t typeIndex = TypeDatabase::Data::Get().typeCounter++;
-		return typeIndex;
-	}
-};
-
 
 
 // -----------------------------------
@@ -442,22 +432,21 @@ namespace TypeDatabase
 	private:
 		static Data* pInstance;
 	};
+}
 
-	template<typename T>
-	bool TypeExists()
-	{
-		if (DefaultTypeResolver::Get<T>() == TypeData("UnknownType", 0))
-			return false;
-		return true;
-	}
-
-	// Generic typedata return
-	template<typename T>
-	TypeData& Get()
+/**
+ * Type Index retrieval
+ * Note that these indexes are not stable between runs
+ * Use like Type::Index<T>()
+ **/
+struct Type {
+    template<typename Type>
+    inline static uint32_t Index()
 	{
-		return DefaultTypeResolver::Get<T>();
+		static uint32_t typeIndex = TypeDatabase::Data::Get().typeCounter++;
+		return typeIndex;
 	}
-}
+};
 
 // Type resolving mechanism
 template<typename T>
@@ -485,6 +474,9 @@ TypeData& getPrimitiveTypeData<EntityID>();
 struct AssetHandle;
 template <>
 TypeData& getPrimitiveTypeData<AssetHandle>();
+struct InternedString;
+template <>
+TypeData& getPrimitiveTypeData<InternedString>();
 
 struct DefaultTypeResolver 
 {
@@ -510,6 +502,24 @@ struct DefaultTypeResolver
 	}
 };
 
+namespace TypeDatabase
+{
+	template<typename T>
+	bool TypeExists()
+	{
+		if (DefaultTypeResolver::Get<T>() == TypeData("UnknownType", 0))
+			return false;
+		return true;
+	}
+
+	// Generic typedata return
+	template<typename T>
+	TypeData& Get()
+	{
+		return DefaultTypeResolver::Get<T>();
+	}
+}
+
 template<typename T>
 bool Member::IsType()
 {
@@ -557,6 +567,8 @@ struct TypeDataOps
 	virtual Variant New() = 0;
 	virtual Variant CopyToVariant(void* pObject) = 0;
 	virtual void Copy(void* destination, void* pObject) = 0;
+	virtual void CopyConstruct(void* destination, void* pObject) = 0;
+	virtual void Move(void* destination, void* pObject) = 0;
 	virtual void PlacementNew(void* location) = 0;
 	virtual void Destruct(void* pObject) = 0;
 	virtual void Free(void* pObject) = 0;
@@ -580,6 +592,19 @@ struct TypeDataOps_Internal : public TypeDataOps
 		*reinterpret_cast<T*>(destination) = *reinterpret_cast<T*>(pObject);
 	}
 
+	// Copy constructs into uninitialized memory at destination
+	virtual void CopyConstruct(void* destination, void* pObject) override
+	{
+		new (destination) T(*reinterpret_cast<T*>(pObject));
+	}
+
+	// Move constructs into uninitialized memory at destination, and destructs the source
+	virtual void Move(void* destination, void* pObject) override
+	{
+		new (destination) T(eastl::move(*reinterpret_cast<T*>(pObject)));
+		static_cast<T*>(pObject)->~T();
+	}
+
 	virtual void PlacementNew(void* location) override
 	{
 		new (location) T();
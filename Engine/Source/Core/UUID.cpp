@@ -23,6 +23,21 @@ Uuid Uuid::New()
 #endif
 }
 
+Uuid Uuid::Derive(uint32_t n) const
+{
+    // Splitmix64 finalizer, so every bit of both halves depends on n
+    auto mix = [](uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    };
+
+    Uuid derived;
+    derived.data.u64[0] = mix(data.u64[0] ^ mix(data.u64[1] + uint64_t(n) + 1));
+    derived.data.u64[1] = mix(data.u64[1] ^ derived.data.u64[0]);
+    return derived;
+}
+
 eastl::string Uuid::ToString()
 {
     eastl::string output;
@@ -47,7 +62,7 @@ bool Uuid::operator==(const Uuid& other) const
 
 bool Uuid::operator!=(const Uuid& other) const
 {
-    return data.u64[0] != other.data.u64[0] && data.u64[1] != other.data.u64[1];
+    return data.u64[0] != other.data.u64[0] || data.u64[1] != other.data.u64[1];
 }
 
 bool Uuid::operator<(const Uuid& other) const
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "EASTL/string.h"
+#include "EASTL/functional.h"
 
 class Uuid
 {
@@ -9,6 +10,10 @@ public:
 
     static Uuid New();
 
+    // Makes another id from this one and a number, without going to the OS for a new one
+    // For things that belong to something with an id of its own, like the components of an entity
+    Uuid Derive(uint32_t n) const;
+
     eastl::string ToString();
 
     bool IsNill();
@@ -19,9 +24,21 @@ public:
 
     bool operator<(const Uuid& other) const;
 
+    // Uuids are random already, so folding the halves together makes a good enough hash
+    size_t Hash() const { return size_t(data.u64[0] ^ data.u64[1]); }
+
 private:
     union{
         uint8_t u8[16];
         uint64_t u64[2];
     } data;
-};
\ No newline at end of file
+};
+
+namespace eastl
+{
+    template<>
+    struct hash<Uuid>
+    {
+        size_t operator()(const Uuid& uuid) const { return uuid.Hash(); }
+    };
+}
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "EASTL/iterator.h"
 
 struct TypeData;
+namespace TypeDatabase { template<typename T> TypeData& Get(); }
 
 // -----------------------------------
 // --------CUSTOM TYPE TRAITS---------
@@ -45,7 +46,7 @@ typedef void* VariantData;
 
 struct Variant
 {
-    template<typename T, typename Decayed = DecayExceptArray<T>::type>
+    template<typename T, typename Decayed = typename DecayExceptArray<T>::type>
     using DecayedIsNotVariant = eastl::enable_if_t<!eastl::is_same<Decayed, Variant>::value, Decayed>;
 
     /**
@@ -0,0 +1,175 @@
+#include "VirtualArena.h"
+
+#include "ErrorHandling.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Address space is cheap on 64 bit, so regions are made big enough that most scenes only ever need one
+    const size_t REGION_RESERVE_SIZE = 256 * 1024 * 1024;
+
+    // Committing well ahead of what's used means few trips to the OS, and pages get faulted in a batch at a time
+    const size_t COMMIT_STEP = 256 * 1024;
+
+    size_t AlignSize(size_t size, size_t alignment)
+    {
+        return (size + alignment - 1) & ~(alignment - 1);
+    }
+
+    // Some systems have pages bigger than the commit step, so it's rounded up to whole pages
+    size_t CommitStep()
+    {
+        static size_t commitStep = AlignSize(COMMIT_STEP, VirtualArena::PageSize());
+        return commitStep;
+    }
+
+    // The pages that lie wholly inside some memory. Pages it shares with neighbouring allocations aren't included,
+    // as they have to stay committed, so with pages bigger than the memory there may be none at all
+    size_t GetWholePages(void* pMemory, size_t nBytes, char*& pFirstPage)
+    {
+        size_t pageSize = VirtualArena::PageSize();
+        size_t start = AlignSize(reinterpret_cast<uintptr_t>(pMemory), pageSize);
+        size_t end = (reinterpret_cast<uintptr_t>(pMemory) + nBytes) & ~(pageSize - 1);
+        pFirstPage = reinterpret_cast<char*>(start);
+        return end > start ? end - start : 0;
+    }
+
+    char* ReserveMemory(size_t size)
+    {
+#ifdef _WIN32
+        return static_cast<char*>(VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS));
+#else
+        void* pMemory = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        return pMemory == MAP_FAILED ? nullptr : static_cast<char*>(pMemory);
+#endif
+    }
+
+    bool CommitMemory(char* pMemory, size_t size)
+    {
+#ifdef _WIN32
+        return VirtualAlloc(pMemory, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+        // Mapping over the reservation lets us fault the pages in all at once, rather than one at a time as they're first touched
+        void* pCommitted = mmap(pMemory, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_POPULATE, -1, 0);
+        return pCommitted != MAP_FAILED;
+#endif
+    }
+
+    void DecommitMemory(char* pMemory, size_t size)
+    {
+#ifdef _WIN32
+        VirtualFree(pMemory, size, MEM_DECOMMIT);
+#else
+        madvise(pMemory, size, MADV_DONTNEED);
+        mprotect(pMemory, size, PROT_NONE);
+#endif
+    }
+
+    void ReleaseMemory(char* pMemory, size_t size)
+    {
+#ifdef _WIN32
+        VirtualFree(pMemory, 0, MEM_RELEASE);
+#else
+        munmap(pMemory, size);
+#endif
+    }
+}
+
+// ***********************************************************************
+
+VirtualArena::~VirtualArena()
+{
+    Release();
+}
+
+// ***********************************************************************
+
+void* VirtualArena::Allocate(size_t nBytes, size_t alignment)
+{
+    ASSERT((alignment & (alignment - 1)) == 0, "Alignment must be a power of 2");
+    ASSERT(alignment <= PageSize(), "Arena allocations can't be aligned to more than a page");
+
+    size_t start = regions.empty() ? 0 : AlignSize(regions.back().offset, alignment);
+    if (regions.empty() || start + nBytes > regions.back().reservedSize)
+    {
+        // Regions start on a page boundary, so they're already aligned enough
+        Region region;
+        size_t neededSize = AlignSize(nBytes, CommitStep());
+        region.reservedSize = neededSize > REGION_RESERVE_SIZE ? neededSize : REGION_RESERVE_SIZE;
+        region.pBase = ReserveMemory(region.reservedSize);
+        ASSERT(region.pBase != nullptr, "Failed to reserve address space for arena");
+        regions.push_back(region);
+        start = 0;
+    }
+
+    Region& region = regions.back();
+    size_t end = start + nBytes;
+    if (end > region.committedSize)
+    {
+        size_t newCommittedSize = AlignSize(end, CommitStep());
+        if (newCommittedSize > region.reservedSize)
+            newCommittedSize = region.reservedSize;
+        bool committed = CommitMemory(region.pBase + region.committedSize, newCommittedSize - region.committedSize);
+        ASSERT(committed, "Failed to commit arena memory, out of memory?");
+        committedBytes += newCommittedSize - region.committedSize;
+        region.committedSize = newCommittedSize;
+    }
+    region.offset = end;
+    return region.pBase + start;
+}
+
+// ***********************************************************************
+
+void VirtualArena::Decommit(void* pMemory, size_t nBytes)
+{
+    char* pFirstPage;
+    size_t size = GetWholePages(pMemory, nBytes, pFirstPage);
+    if (size == 0)
+        return;
+    DecommitMemory(pFirstPage, size);
+    committedBytes -= size;
+}
+
+// ***********************************************************************
+
+void VirtualArena::Recommit(void* pMemory, size_t nBytes)
+{
+    // Exactly the pages Decommit gave back, committing over the shared ones would wipe the neighbours
+    char* pFirstPage;
+    size_t size = GetWholePages(pMemory, nBytes, pFirstPage);
+    if (size == 0)
+        return;
+    bool committed = CommitMemory(pFirstPage, size);
+    ASSERT(committed, "Failed to recommit arena memory, out of memory?");
+    committedBytes += size;
+}
+
+// ***********************************************************************
+
+void VirtualArena::Release()
+{
+    for (Region& region : regions)
+    {
+        ReleaseMemory(region.pBase, region.reservedSize);
+    }
+    regions.clear();
+    committedBytes = 0;
+}
+
+// ***********************************************************************
+
+size_t VirtualArena::PageSize()
+{
+#ifdef _WIN32
+    static size_t pageSize = []() { SYSTEM_INFO info; GetSystemInfo(&info); return size_t(info.dwPageSize); }();
+#else
+    static size_t pageSize = size_t(sysconf(_SC_PAGESIZE));
+#endif
+    return pageSize;
+}
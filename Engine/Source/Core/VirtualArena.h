@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <EASTL/vector.h>
+
+// Bump allocator over reserved virtual memory
+// Address space is reserved in large regions up front, and pages are only committed as allocations reach them,
+// so an arena can be sized generously without costing real memory. Nothing is freed on its own, everything the
+// arena handed out is given back to the OS in one go when it's destroyed or Released
+struct VirtualArena
+{
+	VirtualArena() {}
+	~VirtualArena();
+
+	VirtualArena(const VirtualArena&) = delete;
+	VirtualArena& operator=(const VirtualArena&) = delete;
+
+	// Alignment must be a power of 2, and no more than the page size
+	void* Allocate(size_t nBytes, size_t alignment = 64);
+
+	// Gives the pages of a previous allocation back to the OS, but keeps the addresses so it can be recommitted
+	// Only pages wholly inside the memory are given back, ones shared with other allocations stay committed,
+	// so allocations smaller than a page may not give anything back. Treat the contents as lost either way
+	// Recommit must be given the same memory that was decommitted
+	void Decommit(void* pMemory, size_t nBytes);
+	void Recommit(void* pMemory, size_t nBytes);
+
+	// Frees every allocation at once
+	void Release();
+
+	size_t GetCommittedBytes() const { return committedBytes; }
+
+	static size_t PageSize();
+
+	struct Region
+	{
+		char* pBase{ nullptr };
+		size_t reservedSize{ 0 };
+		size_t committedSize{ 0 };
+		size_t offset{ 0 };
+	};
+	eastl::vector<Region> regions;
+
+	size_t committedBytes{ 0 };
+};
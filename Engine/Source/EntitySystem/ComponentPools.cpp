@@ -0,0 +1,132 @@
+#include "ComponentPools.h"
+
+#include "Entity.h"
+#include "IComponent.h"
+#include "VirtualArena.h"
+#include "ErrorHandling.h"
+
+#include <EASTL/vector.h>
+#include <SDL_atomic.h>
+
+namespace
+{
+    // Enough for anything in a component, including the vector maths types
+    const size_t SLOT_ALIGNMENT = 16;
+
+    // Slabs of at least this size, or room for MIN_SLAB_SLOTS if the type is too big for that
+    const size_t SLAB_SIZE = 16 * 1024;
+    const size_t MIN_SLAB_SLOTS = 8;
+
+    size_t AlignSize(size_t size, size_t alignment)
+    {
+        return (size + alignment - 1) & ~(alignment - 1);
+    }
+
+    struct Pools
+    {
+        VirtualArena slabArena;
+        eastl::vector<SlabPool*> componentPools; // Indexed by TypeData id
+        SlabPool entityPool{ sizeof(Entity), &slabArena };
+
+        SlabPool& GetComponentPool(TypeData& type)
+        {
+            if (type.id >= componentPools.size())
+                componentPools.resize(type.id + 1, nullptr);
+
+            SlabPool*& pPool = componentPools[type.id];
+            if (pPool == nullptr)
+                pPool = new SlabPool(type.size, &slabArena);
+            return *pPool;
+        }
+    };
+
+    // Components can be made from static initializers, and must outlive every entity, so the pools are made on first use and never freed
+    Pools& GetPools()
+    {
+        static Pools* pPools = new Pools();
+        return *pPools;
+    }
+
+    SDL_SpinLock poolsLock{ 0 };
+}
+
+// ***********************************************************************
+
+SlabPool::SlabPool(size_t objectSize, VirtualArena* _pSlabArena) : pSlabArena(_pSlabArena)
+{
+    // Free slots hold the next free slot in their first bytes, so there must be room for a pointer
+    slotSize = AlignSize(objectSize < sizeof(void*) ? sizeof(void*) : objectSize, SLOT_ALIGNMENT);
+    slabSize = slotSize * MIN_SLAB_SLOTS > SLAB_SIZE ? AlignSize(slotSize * MIN_SLAB_SLOTS, SLAB_SIZE) : SLAB_SIZE;
+}
+
+// ***********************************************************************
+
+void* SlabPool::Allocate()
+{
+    if (pFreeList)
+    {
+        void* pSlot = pFreeList;
+        pFreeList = *static_cast<void**>(pSlot);
+        return pSlot;
+    }
+
+    if (pSlabCursor == nullptr || pSlabCursor + slotSize > pSlabEnd)
+    {
+        pSlabCursor = static_cast<char*>(pSlabArena->Allocate(slabSize));
+        pSlabEnd = pSlabCursor + slabSize;
+    }
+
+    void* pSlot = pSlabCursor;
+    pSlabCursor += slotSize;
+    return pSlot;
+}
+
+// ***********************************************************************
+
+void SlabPool::Free(void* pObject)
+{
+    *static_cast<void**>(pObject) = pFreeList;
+    pFreeList = pObject;
+}
+
+// ***********************************************************************
+
+void* ComponentPools::Allocate(TypeData& type)
+{
+    SDL_AtomicLock(&poolsLock);
+    void* pMemory = GetPools().GetComponentPool(type).Allocate();
+    SDL_AtomicUnlock(&poolsLock);
+    return pMemory;
+}
+
+// ***********************************************************************
+
+void ComponentPools::Destroy(IComponent* pComponent)
+{
+    // Must come from the component before it's destructed
+    TypeData& type = pComponent->GetTypeData();
+    pComponent->~IComponent();
+
+    SDL_AtomicLock(&poolsLock);
+    GetPools().GetComponentPool(type).Free(pComponent);
+    SDL_AtomicUnlock(&poolsLock);
+}
+
+// ***********************************************************************
+
+void* ComponentPools::AllocateEntity()
+{
+    SDL_AtomicLock(&poolsLock);
+    void* pMemory = GetPools().entityPool.Allocate();
+    SDL_AtomicUnlock(&poolsLock);
+    return pMemory;
+}
+
+// ***********************************************************************
+
+void ComponentPools::FreeEntity(void* pEntity)
+{
+    SDL_AtomicLock(&poolsLock);
+    GetPools().entityPool.Free(pEntity);
+    SDL_AtomicUnlock(&poolsLock);
+}
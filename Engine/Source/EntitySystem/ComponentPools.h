@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct TypeData;
+struct IComponent;
+struct VirtualArena;
+
+// Fixed size slots cut from slabs of memory, with freed slots kept on a free list to be handed out again
+// Slabs come from the arena and are never given back on their own, so an object's address stays the same for its whole life
+struct SlabPool
+{
+	SlabPool(size_t objectSize, VirtualArena* _pSlabArena);
+
+	void* Allocate();
+	void Free(void* pObject);
+
+	VirtualArena* pSlabArena;
+	size_t slotSize;
+	size_t slabSize;
+
+	void* pFreeList{ nullptr };
+	char* pSlabCursor{ nullptr };
+	char* pSlabEnd{ nullptr };
+};
+
+// Memory for the components that entities own, with a pool per component type
+// Components of one type end up close together, rather than wherever the heap put them, and spawning and
+// destroying entities reuses slots instead of going to malloc. Safe to use from any thread
+namespace ComponentPools
+{
+	// Memory for one instance of type, construct the component into it
+	void* Allocate(TypeData& type);
+
+	// Destructs the component and gives its memory back to the pool for its type
+	void Destroy(IComponent* pComponent);
+
+	// For entities themselves, which are all the same size
+	void* AllocateEntity();
+	void FreeEntity(void* pEntity);
+}
@@ -1,16 +1,17 @@
 #include "Entity.h"
 
 #include "Systems.h"
+#include "SpatialComponent.h"
 
 REFLECT_BEGIN(IComponent)
 REFLECT_END()
 
 Entity::~Entity()
 {
-    // Delete entities
+    // Delete components
     for(IComponent* pComponent : components)
     {
-        delete pComponent;
+        ComponentPools::Destroy(pComponent);
     }
 
     for(IEntitySystem* pSystem : systems)
@@ -19,15 +20,28 @@ Entity::~Entity()
     }
 }
 
+void* Entity::operator new(size_t size)
+{
+    ASSERT(size == sizeof(Entity), "Entities are pooled, so can't be derived from");
+    return ComponentPools::AllocateEntity();
+}
+
+void Entity::operator delete(void* pMemory)
+{
+    ComponentPools::FreeEntity(pMemory);
+}
+
 eastl::vector<IComponent*> Entity::Activate()
 {
     eastl::vector<IComponent*> componentsToReturn;
     for (IComponent* pComponent : components)
     {
         componentsToReturn.push_back(pComponent);
+        uint32_t typeId = pComponent->GetTypeData().id;
         for (IEntitySystem* pSystem : systems)
         {
-            pSystem->RegisterComponent(pComponent);
+            if (pSystem->subscriptions.Wants(typeId))
+                pSystem->RegisterComponent(pComponent);
         }
     }
     return componentsToReturn;
@@ -39,9 +53,11 @@ eastl::vector<IComponent*> Entity::Deactivate()
     for (IComponent* pComponent : components)
     {
         componentsToReturn.push_back(pComponent);
+        uint32_t typeId = pComponent->GetTypeData().id;
         for (IEntitySystem* pSystem : systems)
         {
-            pSystem->UnregisterComponent(pComponent);
+            if (pSystem->subscriptions.Wants(typeId))
+                pSystem->UnregisterComponent(pComponent);
         }
     }
     return componentsToReturn;
@@ -55,6 +71,24 @@ void Entity::Update(UpdateContext& ctx)
     }
 }
 
+void Entity::UpdateLocalSystems(UpdateContext& ctx)
+{
+    for (IEntitySystem* pSystem : systems)
+    {
+        if (pSystem->isEntityLocal)
+            pSystem->Update(ctx);
+    }
+}
+
+void Entity::UpdateSharedSystems(UpdateContext& ctx)
+{
+    for (IEntitySystem* pSystem : systems)
+    {
+        if (!pSystem->isEntityLocal)
+            pSystem->Update(ctx);
+    }
+}
+
 void Entity::DestroyComponent(Uuid componentId)
 {
     eastl::vector<IComponent*>::iterator found = eastl::find_if(components.begin(), components.end(),
@@ -64,4 +98,10 @@ void Entity::DestroyComponent(Uuid componentId)
     {
         components.erase(found);
     }
-}
\ No newline at end of file
+}
+
+void Entity::SetSpatialParent(SpatialComponent* pSpatial, IComponent* pPotentialParent)
+{
+    ASSERT(pPotentialParent->GetTypeData().IsDerivedFrom<SpatialComponent>(), "Attempting to parent to a non spatial component. Not allowed");
+    pSpatial->SetParent(static_cast<SpatialComponent*>(pPotentialParent));
+}
@@ -4,6 +4,9 @@
 #include "EASTL/string.h"
 #include "UUID.h"
 #include "IComponent.h"
+#include "ComponentPools.h"
+
+#include <new>
 
 class IEntitySystem;
 struct UpdateContext;
@@ -16,6 +19,10 @@ public:
 
     ~Entity();
 
+    // Entities and their components come from pools rather than the general heap, see ComponentPools.h
+    static void* operator new(size_t size);
+    static void operator delete(void* pMemory);
+
     Uuid GetId() const { return id; }
 
     // This function will loop through components and register them with the systems
@@ -26,11 +33,16 @@ public:
 
 	// Loops through systems updating them
 	void Update(UpdateContext& ctx);
+
+	// Update in two halves, for worlds updating entities in parallel
+	// The entity local systems can be updated from any thread, and the rest are then updated on the main thread
+	void UpdateLocalSystems(UpdateContext& ctx);
+	void UpdateSharedSystems(UpdateContext& ctx);
     
     template<typename Type, eastl::enable_if_t<!eastl::is_base_of<SpatialComponent, Type>::value, int> = 0>
     Type* AddNewComponent(Uuid spatialParent = Uuid())
     {
-        Type* pComponent = new Type();
+        Type* pComponent = NewPooledComponent<Type>();
         pComponent->owningEntityId = GetId();
         components.push_back(static_cast<IComponent*>(pComponent));
         return pComponent;
@@ -39,7 +51,7 @@ public:
     template<typename Type, eastl::enable_if_t<eastl::is_base_of<SpatialComponent, Type>::value, int> = 0>
     Type* AddNewComponent(Uuid spatialParent = Uuid())
     {
-        Type* pComponent = new Type();
+        Type* pComponent = NewPooledComponent<Type>();
         pComponent->owningEntityId = GetId();
         components.push_back(static_cast<IComponent*>(pComponent));
 
@@ -49,13 +61,7 @@ public:
             [&spatialParent] (const IComponent* pComp) { return pComp->GetId() == spatialParent; });
 
             if (found != components.end())
-            {
-                IComponent* pPotentialParent = *found;
-                ASSERT(pPotentialParent->GetTypeData().IsDerivedFrom<SpatialComponent>(), "Attempting to parent to a non spatial component. Not allowed");
-                
-                SpatialComponent* pSpatial = static_cast<SpatialComponent*>(pComponent);
-                pSpatial->SetParent(static_cast<SpatialComponent*>(pPotentialParent));
-            }
+                SetSpatialParent(pComponent, *found);
         }
         return pComponent;
     }
@@ -70,11 +76,36 @@ public:
 
     void DestroyComponent(Uuid componentId);
 
+    // The first component of exactly this type, or nullptr if there isn't one
+    template<typename Type>
+    Type* GetComponent()
+    {
+        for (IComponent* pComponent : components)
+        {
+            if (pComponent->GetTypeData() == TypeDatabase::Get<Type>())
+                return static_cast<Type*>(pComponent);
+        }
+        return nullptr;
+    }
+
     eastl::vector<IComponent*> const& GetComponents() const { return components; }
 
 	eastl::string name;
 
 private:
+    friend class Prefab;
+
+    // Out of line, since SpatialComponent can't be complete in this header
+    void SetSpatialParent(SpatialComponent* pSpatial, IComponent* pPotentialParent);
+
+    template<typename Type>
+    Type* NewPooledComponent()
+    {
+        TypeData& type = TypeDatabase::Get<Type>();
+        ASSERT(type.size == sizeof(Type), "Component type is missing its own reflection, so it can't be pooled");
+        return new (ComponentPools::Allocate(type)) Type();
+    }
+
     Uuid id;
 
 	eastl::vector<IComponent*> components;
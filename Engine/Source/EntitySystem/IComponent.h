@@ -6,8 +6,10 @@
 struct IComponent
 {
     friend class Entity;
+    friend class Prefab;
     
     IComponent() : id(Uuid::New()) {}
+    virtual ~IComponent() {}
 
     REFLECT_DERIVED()
 
@@ -0,0 +1,87 @@
+#include "Prefab.h"
+
+#include "World.h"
+#include "SpatialComponent.h"
+
+namespace
+{
+    const int NOT_SPATIAL = -2;
+    const int SPATIAL_ROOT = -1;
+}
+
+Prefab::Prefab(eastl::string name)
+{
+    templateEntity.name = name;
+}
+
+void Prefab::Instantiate(World& world, int count, Entity** ppOutEntities)
+{
+    const eastl::vector<IComponent*>& templateComponents = templateEntity.components;
+
+    // Spatial parents as indices into the template's components, worked out once for the whole batch
+    eastl::vector<int> spatialParents(templateComponents.size(), NOT_SPATIAL);
+    for (size_t i = 0; i < templateComponents.size(); i++)
+    {
+        if (!templateComponents[i]->GetTypeData().IsDerivedFrom<SpatialComponent>())
+            continue;
+
+        spatialParents[i] = SPATIAL_ROOT;
+        SpatialComponent* pParent = static_cast<SpatialComponent*>(templateComponents[i])->pParent;
+        for (size_t j = 0; j < i && pParent; j++)
+        {
+            if (templateComponents[j] == pParent)
+                spatialParents[i] = int(j);
+        }
+    }
+
+    eastl::vector<Entity*> instances;
+    if (ppOutEntities == nullptr)
+    {
+        instances.resize(count);
+        ppOutEntities = instances.data();
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        // Only the entity goes to the OS for an id, its components' ids are derived from it
+        Entity* pEntity = new Entity();
+        pEntity->name = templateEntity.name;
+        pEntity->components.reserve(templateComponents.size());
+
+        for (size_t c = 0; c < templateComponents.size(); c++)
+        {
+            IComponent* pSource = templateComponents[c];
+            TypeData& type = pSource->GetTypeData();
+
+            IComponent* pComponent = static_cast<IComponent*>(ComponentPools::Allocate(type));
+            type.pTypeOps->CopyConstruct(pComponent, pSource);
+            pComponent->id = pEntity->id.Derive(uint32_t(c));
+            pComponent->owningEntityId = pEntity->id;
+
+            // The copy still points at the template's spatial parent and children
+            if (spatialParents[c] != NOT_SPATIAL)
+            {
+                SpatialComponent* pSpatial = static_cast<SpatialComponent*>(pComponent);
+                pSpatial->pParent = nullptr;
+                pSpatial->children.clear();
+            }
+            pEntity->components.push_back(pComponent);
+        }
+
+        // Transforms were copied along with everything else, so linking up is all that's needed
+        for (size_t c = 0; c < templateComponents.size(); c++)
+        {
+            if (spatialParents[c] < 0)
+                continue;
+
+            SpatialComponent* pSpatial = static_cast<SpatialComponent*>(pEntity->components[c]);
+            SpatialComponent* pParent = static_cast<SpatialComponent*>(pEntity->components[spatialParents[c]]);
+            pSpatial->pParent = pParent;
+            pParent->children.push_back(pSpatial);
+        }
+
+        ppOutEntities[i] = pEntity;
+    }
+
+    world.AddEntities(ppOutEntities, count);
+}
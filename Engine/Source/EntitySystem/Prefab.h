@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Entity.h"
+
+class World;
+
+// An entity that's built once and then stamped out as many times as you like
+// Set it up as you would any entity, then Instantiate makes copies of it in a world. Each copy's components
+// are copy constructed straight from the template, and only what has to differ per instance is patched afterwards,
+// that is the entity and component ids, the owning entity, and spatial parents.
+// Uuids stored in component members are copied as they are, and entity systems aren't part of prefabs
+class Prefab
+{
+public:
+	Prefab(eastl::string name);
+
+	template<typename Type>
+	Type* AddNewComponent(Uuid spatialParent = Uuid())
+	{
+		return templateEntity.AddNewComponent<Type>(spatialParent);
+	}
+
+	// Makes count copies of the template in the world, written to ppOutEntities if it's given so they can be customized
+	// They're given to the world all together, so its systems hear about the whole batch on the same update
+	void Instantiate(World& world, int count, Entity** ppOutEntities = nullptr);
+
+	Entity& GetTemplate() { return templateEntity; }
+
+private:
+	Entity templateEntity;
+};
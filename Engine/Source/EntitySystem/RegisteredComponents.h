@@ -0,0 +1,90 @@
+#pragma once
+
+#include "EASTL/vector.h"
+#include "EASTL/hash_map.h"
+#include "EASTL/sort.h"
+
+// The components a system has been registered with, kept in a flat list to loop over
+// Each component's slot is remembered in a side table, so removing one goes straight to it and swaps the last
+// component into the gap, instead of searching the list and shifting everything after it down. Removals therefore
+// shuffle the order, so systems that depend on registration order, like ones drawing with blending, should call
+// RestoreOrder before looping over the components
+template<typename Type>
+class RegisteredComponents
+{
+public:
+	using const_iterator = typename eastl::vector<Type*>::const_iterator;
+
+	void Add(Type* pComponent)
+	{
+		if (slots.find(pComponent) != slots.end())
+			return;
+
+		slots[pComponent] = components.size();
+		components.push_back(pComponent);
+		sequence.push_back(nextSequence++);
+	}
+
+	// Returns false if the component wasn't registered
+	bool Remove(Type* pComponent)
+	{
+		typename eastl::hash_map<Type*, size_t>::iterator found = slots.find(pComponent);
+		if (found == slots.end())
+			return false;
+
+		size_t slot = found->second;
+		slots.erase(found);
+
+		if (slot != components.size() - 1)
+		{
+			components[slot] = components.back();
+			sequence[slot] = sequence.back();
+			slots[components[slot]] = slot;
+			isOrdered = false;
+		}
+		components.pop_back();
+		sequence.pop_back();
+		return true;
+	}
+
+	// Puts the components back in the order they were added, does nothing unless a removal has moved them
+	void RestoreOrder()
+	{
+		if (isOrdered)
+			return;
+
+		eastl::vector<eastl::pair<uint64_t, Type*>> ordered;
+		ordered.reserve(components.size());
+		for (size_t i = 0; i < components.size(); i++)
+		{
+			ordered.push_back(eastl::make_pair(sequence[i], components[i]));
+		}
+		eastl::sort(ordered.begin(), ordered.end());
+
+		for (size_t i = 0; i < ordered.size(); i++)
+		{
+			sequence[i] = ordered[i].first;
+			components[i] = ordered[i].second;
+			slots[components[i]] = i;
+		}
+		isOrdered = true;
+	}
+
+	bool Contains(Type* pComponent) const { return slots.find(pComponent) != slots.end(); }
+
+	size_t size() const { return components.size(); }
+	bool empty() const { return components.empty(); }
+
+	Type* operator[](size_t index) const { return components[index]; }
+
+	const_iterator begin() const { return components.begin(); }
+	const_iterator end() const { return components.end(); }
+
+private:
+	eastl::vector<Type*> components;
+	eastl::vector<uint64_t> sequence; // When each component was added, in the same order as components
+	eastl::hash_map<Type*, size_t> slots; // Component -> its index in components
+
+	uint64_t nextSequence{ 0 };
+	bool isOrdered{ true };
+};
@@ -6,6 +6,7 @@
 struct SpatialComponent : public IComponent
 {
     friend class Entity;
+    friend class Prefab;
 
     REFLECT_DERIVED()
 
@@ -1,24 +1,137 @@
 #pragma once
 
+#include "TypeSystem.h"
+#include "EASTL/vector.h"
+#include "EASTL/algorithm.h"
+
 struct IComponent;
 struct FrameContext;
 struct UpdateContext;
 class Entity;
 
+// The component types a system wants to be registered with
+// Systems fill these in from their constructors with Subscribe<Type>(), and from then on only components of exactly
+// those types are passed to RegisterComponent and UnregisterComponent. A system that subscribes to nothing is given every component
+struct ComponentSubscriptions
+{
+	template<typename Type>
+	void Subscribe()
+	{
+		typeIds.push_back(TypeDatabase::Get<Type>().id);
+	}
+
+	bool Wants(uint32_t typeId) const
+	{
+		return typeIds.empty() || eastl::find(typeIds.begin(), typeIds.end(), typeId) != typeIds.end();
+	}
+
+	eastl::vector<uint32_t> typeIds; // TypeData ids
+};
+
+// What a world system's Update reads and writes, so the world knows which systems it can update at the same time
+// Systems fill this in from their constructors. Systems that conflict are updated in registration order unless After
+// says otherwise, and a system that declares nothing is exclusive, so it's updated on its own on the world's thread, like every system used to be
+struct WorldSystemAccess
+{
+	template<typename... ComponentTypes>
+	WorldSystemAccess& Reads()
+	{
+		AddTypeIds<ComponentTypes...>(reads);
+		exclusive = false;
+		return *this;
+	}
+
+	template<typename... ComponentTypes>
+	WorldSystemAccess& Writes()
+	{
+		AddTypeIds<ComponentTypes...>(writes);
+		exclusive = false;
+		return *this;
+	}
+
+	// For systems that create or destroy entities, which the world can only take from one system at a time
+	WorldSystemAccess& ChangesEntities()
+	{
+		changesEntities = true;
+		exclusive = false;
+		return *this;
+	}
+
+	// For systems that don't do anything in Update, like ones that only draw
+	WorldSystemAccess& UpdatesNothing()
+	{
+		exclusive = false;
+		return *this;
+	}
+
+	// Always update after systems of this type, wherever they were registered
+	// If After dependencies form a loop, a warning is logged and the earliest registered system in it goes first
+	template<typename SystemType>
+	WorldSystemAccess& After()
+	{
+		after.push_back(Type::Index<SystemType>());
+		return *this;
+	}
+
+	bool ConflictsWith(const WorldSystemAccess& other) const
+	{
+		if (exclusive || other.exclusive)
+			return true;
+		if (changesEntities && other.changesEntities)
+			return true;
+		return Intersects(writes, other.reads) || Intersects(writes, other.writes) || Intersects(reads, other.writes);
+	}
+
+	eastl::vector<uint32_t> reads; // TypeData ids
+	eastl::vector<uint32_t> writes; // TypeData ids
+	eastl::vector<uint32_t> after; // Type indices of systems
+	bool changesEntities{ false };
+	bool exclusive{ true };
+
+private:
+	template<typename... ComponentTypes>
+	static void AddTypeIds(eastl::vector<uint32_t>& ids)
+	{
+		uint32_t typeIds[] = { 0, TypeDatabase::Get<ComponentTypes>().id... };
+		ids.insert(ids.end(), typeIds + 1, typeIds + 1 + sizeof...(ComponentTypes));
+	}
+
+	static bool Intersects(const eastl::vector<uint32_t>& a, const eastl::vector<uint32_t>& b)
+	{
+		for (uint32_t id : a)
+		{
+			if (eastl::find(b.begin(), b.end(), id) != b.end())
+				return true;
+		}
+		return false;
+	}
+};
+
 class IEntitySystem
 {
 public:
+    virtual ~IEntitySystem() {}
+
     virtual void Activate() = 0;
 	virtual void RegisterComponent(IComponent* pComponent) = 0;
 	virtual void UnregisterComponent(IComponent* pComponent) = 0;
 
 	virtual void Update(UpdateContext& ctx) {};
 	virtual void Draw(UpdateContext& ctx, FrameContext& frameCtx) {};
+
+	ComponentSubscriptions subscriptions;
+
+	// Set from the constructor if Update only reads and writes this entity's own components
+	// Worlds that update entities in parallel run these on worker threads alongside other entities' systems,
+	// so they must not create or destroy entities, or touch anything shared, like other entities or devices
+	bool isEntityLocal{ false };
 };
 
 class IWorldSystem
 {
 public:
+    virtual ~IWorldSystem() {}
+
     virtual void Activate() = 0;
     virtual void Deactivate() = 0;
 	virtual void RegisterComponent(Entity* pEntity, IComponent* pComponent) = 0;
@@ -26,4 +139,7 @@ public:
 
 	virtual void Update(UpdateContext& ctx) {};
 	virtual void Draw(UpdateContext& ctx, FrameContext& frameCtx) {};
+
+	ComponentSubscriptions subscriptions;
+	WorldSystemAccess access;
 };
\ No newline at end of file
@@ -2,7 +2,33 @@
 
 #include "Entity.h"
 #include "Systems.h"
+#include "Jobs.h"
+#include "ErrorHandling.h"
+#include "Log.h"
 
+#include "EASTL/sort.h"
+
+namespace
+{
+    // Most entity updates are tiny, so entities go to the workers in batches to keep the queue overhead down
+    const size_t ENTITY_BATCH_SIZE = 64;
+
+    struct EntityBatch
+    {
+        static void Run(void* pData)
+        {
+            EntityBatch* pBatch = static_cast<EntityBatch*>(pData);
+            for (size_t i = 0; i < pBatch->count; i++)
+            {
+                pBatch->ppEntities[i]->UpdateLocalSystems(*pBatch->pCtx);
+            }
+        }
+
+        Entity** ppEntities;
+        size_t count;
+        UpdateContext* pCtx;
+    };
+}
 
 
 World::~World()
@@ -15,6 +41,10 @@ World::~World()
     {
         delete pEntity;
     }
+    for(Entity* pEntity : entitiesToAddQueue)
+    {
+        delete pEntity;
+    }
 
     for(IWorldSystem* pSystem : globalSystems)
     {
@@ -28,19 +58,33 @@ Entity* World::NewEntity(eastl::string name)
     pNewEnt->name = name;
 
     if (!isActive)
-        entities.push_back(pNewEnt);
+        InsertEntity(pNewEnt);
     else
         entitiesToAddQueue.push_back(pNewEnt);
 
     return pNewEnt;
 }
 
+void World::AddEntities(Entity** ppEntities, size_t count)
+{
+    if (isActive)
+    {
+        entitiesToAddQueue.insert(entitiesToAddQueue.end(), ppEntities, ppEntities + count);
+        return;
+    }
+
+    entities.reserve(entities.size() + count);
+    for (size_t i = 0; i < count; i++)
+    {
+        InsertEntity(ppEntities[i]);
+    }
+}
+
 void World::DestroyEntity(Uuid entityId)
 {
-    eastl::vector<Entity*>::iterator found = eastl::find_if(entities.begin(), entities.end(), [&entityId](const Entity* pEntity) { return entityId == pEntity->GetId(); });
-    if (found != entities.end())
+    if (entityIndex.find(entityId) != entityIndex.end())
     {
-        entitiesToDeleteQueue.push_back(*found);
+        entitiesToDeleteQueue.push_back(entityId);
     }
 }
 
@@ -56,10 +100,7 @@ void World::ActivateWorld()
         eastl::vector<IComponent*> comps = pEntity->Activate();
         for (IComponent* pComponent : comps)
         {
-            for (IWorldSystem* pGlobalSystem : globalSystems)
-            {
-                pGlobalSystem->RegisterComponent(pEntity, pComponent);
-            }
+            RegisterWithSystems(pEntity, pComponent);
         }
     }
     isActive = true;
@@ -72,10 +113,7 @@ void World::DeactivateWorld()
         eastl::vector<IComponent*> comps = pEntity->Deactivate();
         for (IComponent* pComponent : comps)
         {
-            for (IWorldSystem* pGlobalSystem : globalSystems)
-            {
-                pGlobalSystem->UnregisterComponent(pEntity, pComponent);
-            }
+            UnregisterWithSystems(pEntity, pComponent);
         }
     }
 
@@ -89,21 +127,21 @@ void World::DeactivateWorld()
 void World::OnUpdate(UpdateContext& ctx)
 {
     // Process entities wanting to be deleted
-    for (Entity* pEntityToDelete : entitiesToDeleteQueue)
+    for (Uuid entityId : entitiesToDeleteQueue)
     {
+        // Entities can be asked to be destroyed more than once in a frame
+        eastl::hash_map<Uuid, size_t>::iterator found = entityIndex.find(entityId);
+        if (found == entityIndex.end())
+            continue;
+
+        Entity* pEntityToDelete = entities[found->second];
         eastl::vector<IComponent*> comps = pEntityToDelete->Deactivate();
         for (IComponent* pComponent : comps)
         {
-            for (IWorldSystem* pGlobalSystem : globalSystems)
-            {
-                pGlobalSystem->UnregisterComponent(pEntityToDelete, pComponent);
-            }
-        }
-        eastl::vector<Entity*>::iterator found = eastl::find(entities.begin(), entities.end(), pEntityToDelete);
-        if (found != entities.end())
-        {
-            entities.erase(found);
+            UnregisterWithSystems(pEntityToDelete, pComponent);
         }
+        RemoveEntity(found);
+        delete pEntityToDelete;
     }
     entitiesToDeleteQueue.clear();
 
@@ -113,42 +151,311 @@ void World::OnUpdate(UpdateContext& ctx)
         eastl::vector<IComponent*> comps = pEntityToAdd->Activate();
         for (IComponent* pComponent : comps)
         {
-            for (IWorldSystem* pGlobalSystem : globalSystems)
-            {
-                pGlobalSystem->RegisterComponent(pEntityToAdd, pComponent);
-            }
+            RegisterWithSystems(pEntityToAdd, pComponent);
         }
-        entities.push_back(pEntityToAdd);
+        InsertEntity(pEntityToAdd);
     }
     entitiesToAddQueue.clear();
 
     // First update entities
-    for (Entity* pEntity : entities)
+    if (parallelEntityUpdates)
     {
-        pEntity->Update(ctx);
+        UpdateEntitiesInParallel(ctx);
     }
-
-    // Then global systems
-    for (IWorldSystem* pSystem : globalSystems)
+    else
     {
-        pSystem->Update(ctx);
+        for (Entity* pEntity : entities)
+        {
+            pEntity->Update(ctx);
+        }
     }
+
+    // Then global systems
+    UpdateGlobalSystems(ctx);
 }
 
 // ***********************************************************************
 
 Entity* World::FindEntity(Uuid entityId)
 {
-    eastl::vector<Entity*>::iterator found = eastl::find_if(entities.begin(), entities.end(), [&entityId](const Entity* pEntity) { return entityId == pEntity->GetId(); });
-    if (found != entities.end())
+    eastl::hash_map<Uuid, size_t>::iterator found = entityIndex.find(entityId);
+    if (found != entityIndex.end())
     {
-        return *found;
+        return entities[found->second];
     }
     return nullptr;
 }
 
 // ***********************************************************************
 
+void World::UpdateEntitiesInParallel(UpdateContext& ctx)
+{
+    // Small worlds aren't worth the overhead of the queue, but the local systems still go first so the order doesn't change
+    if (Jobs::GetWorkerCount() == 0 || entities.size() <= ENTITY_BATCH_SIZE)
+    {
+        for (Entity* pEntity : entities)
+        {
+            pEntity->UpdateLocalSystems(ctx);
+        }
+    }
+    else
+    {
+        eastl::vector<EntityBatch> batches;
+        batches.reserve(entities.size() / ENTITY_BATCH_SIZE + 1);
+        for (size_t start = 0; start < entities.size(); start += ENTITY_BATCH_SIZE)
+        {
+            size_t count = entities.size() - start < ENTITY_BATCH_SIZE ? entities.size() - start : ENTITY_BATCH_SIZE;
+            batches.push_back(EntityBatch{ entities.data() + start, count, &ctx });
+        }
+
+        Jobs::Counter counter;
+        for (EntityBatch& batch : batches)
+        {
+            Jobs::Run(EntityBatch::Run, &batch, &counter);
+        }
+        Jobs::Wait(&counter);
+    }
+
+    // Everything from here on sees the results of all the local updates
+    for (Entity* pEntity : entities)
+    {
+        pEntity->UpdateSharedSystems(ctx);
+    }
+}
+
+// ***********************************************************************
+
+void World::BuildSystemSchedule()
+{
+    uint32_t nSystems = uint32_t(systemNodes.size());
+    for (SystemNode& node : systemNodes)
+    {
+        node.dependents.clear();
+        node.nDependencies = 0;
+        node.pWorld = this;
+    }
+
+    for (uint32_t i = 0; i < nSystems; i++)
+    {
+        const WorldSystemAccess& access = systemNodes[i].pSystem->access;
+        for (uint32_t j = 0; j < nSystems; j++)
+        {
+            if (i == j)
+                continue;
+
+            // Explicit ordering wins, otherwise conflicting systems keep their registration order
+            const WorldSystemAccess& otherAccess = systemNodes[j].pSystem->access;
+            bool isAfter = eastl::find(access.after.begin(), access.after.end(), systemNodes[j].systemType) != access.after.end();
+            bool isBefore = eastl::find(otherAccess.after.begin(), otherAccess.after.end(), systemNodes[i].systemType) != otherAccess.after.end();
+            if (isAfter || (j < i && !isBefore && access.ConflictsWith(otherAccess)))
+            {
+                systemNodes[j].dependents.push_back(i);
+                systemNodes[i].nDependencies++;
+            }
+        }
+    }
+
+    // The order to use when updating serially, the earliest registered system that's ready goes next
+    serialSystemOrder.clear();
+    eastl::vector<int> nWaiting(nSystems);
+    for (uint32_t i = 0; i < nSystems; i++)
+    {
+        nWaiting[i] = systemNodes[i].nDependencies;
+    }
+    while (serialSystemOrder.size() < nSystems)
+    {
+        uint32_t next = 0;
+        while (next < nSystems && nWaiting[next] != 0)
+            next++;
+
+        if (next == nSystems)
+        {
+            // After dependencies form a loop. Rather than leave those systems out, the earliest registered one
+            // goes first, and the systems it was waiting on wait for it instead, so conflicting ones still don't overlap
+            next = 0;
+            while (nWaiting[next] < 0)
+                next++;
+            Log::Warn("Global systems' After dependencies form a loop, system %i is updated before systems it should come after", next);
+
+            for (uint32_t k = 0; k < nSystems; k++)
+            {
+                eastl::vector<uint32_t>& dependents = systemNodes[k].dependents;
+                uint32_t* pEdge = eastl::find(dependents.begin(), dependents.end(), next);
+                if (nWaiting[k] < 0 || pEdge == dependents.end())
+                    continue;
+
+                dependents.erase(pEdge);
+                systemNodes[next].nDependencies--;
+                nWaiting[next]--;
+
+                eastl::vector<uint32_t>& nextDependents = systemNodes[next].dependents;
+                if (eastl::find(nextDependents.begin(), nextDependents.end(), k) == nextDependents.end())
+                {
+                    nextDependents.push_back(k);
+                    systemNodes[k].nDependencies++;
+                    nWaiting[k]++;
+                }
+            }
+        }
+
+        serialSystemOrder.push_back(next);
+        nWaiting[next] = -1;
+        for (uint32_t dependent : systemNodes[next].dependents)
+        {
+            nWaiting[dependent]--;
+        }
+    }
+    isScheduleDirty = false;
+}
+
+// ***********************************************************************
+
+void World::UpdateGlobalSystems(UpdateContext& ctx)
+{
+    if (isScheduleDirty)
+        BuildSystemSchedule();
+
+    if (systemNodes.size() < 2 || Jobs::GetWorkerCount() == 0)
+    {
+        for (uint32_t index : serialSystemOrder)
+        {
+            systemNodes[index].pSystem->Update(ctx);
+        }
+        return;
+    }
+
+    pUpdateContext = &ctx;
+    readySystems.clear();
+    for (uint32_t i = 0; i < (uint32_t)systemNodes.size(); i++)
+    {
+        systemNodes[i].nWaiting = systemNodes[i].nDependencies;
+        if (systemNodes[i].nDependencies == 0)
+            readySystems.push_back(i);
+    }
+
+    // Steps through the graph, each step updates every system whose dependencies have finished
+    // Exclusive systems conflict with everything so they're always alone, and a step of one isn't worth a trip to a worker
+    while (!readySystems.empty())
+    {
+        if (readySystems.size() == 1)
+        {
+            systemNodes[readySystems[0]].pSystem->Update(ctx);
+        }
+        else
+        {
+            for (uint32_t index : readySystems)
+            {
+                Jobs::Run(UpdateSystemNode, &systemNodes[index], &systemsCounter);
+            }
+            Jobs::Wait(&systemsCounter);
+        }
+
+        nextReadySystems.clear();
+        for (uint32_t index : readySystems)
+        {
+            for (uint32_t dependent : systemNodes[index].dependents)
+            {
+                if (--systemNodes[dependent].nWaiting == 0)
+                    nextReadySystems.push_back(dependent);
+            }
+        }
+        // Registration order, which keeps the order we start things in deterministic
+        eastl::sort(nextReadySystems.begin(), nextReadySystems.end());
+        readySystems.swap(nextReadySystems);
+    }
+    pUpdateContext = nullptr;
+}
+
+// ***********************************************************************
+
+void World::UpdateSystemNode(void* pData)
+{
+    SystemNode* pNode = static_cast<SystemNode*>(pData);
+    pNode->pSystem->Update(*pNode->pWorld->pUpdateContext);
+}
+
+// ***********************************************************************
+
+void World::AddSubscriber(IWorldSystem* pSystem)
+{
+    const eastl::vector<uint32_t>& typeIds = pSystem->subscriptions.typeIds;
+    if (typeIds.empty())
+    {
+        unfilteredSystems.push_back(pSystem);
+        return;
+    }
+
+    for (uint32_t typeId : typeIds)
+    {
+        if (typeId >= subscribers.size())
+            subscribers.resize(typeId + 1);
+        subscribers[typeId].push_back(pSystem);
+    }
+}
+
+// ***********************************************************************
+
+void World::RegisterWithSystems(Entity* pEntity, IComponent* pComponent)
+{
+    uint32_t typeId = pComponent->GetTypeData().id;
+    if (typeId < subscribers.size())
+    {
+        for (IWorldSystem* pSystem : subscribers[typeId])
+        {
+            pSystem->RegisterComponent(pEntity, pComponent);
+        }
+    }
+
+    for (IWorldSystem* pSystem : unfilteredSystems)
+    {
+        pSystem->RegisterComponent(pEntity, pComponent);
+    }
+}
+
+// ***********************************************************************
+
+void World::UnregisterWithSystems(Entity* pEntity, IComponent* pComponent)
+{
+    uint32_t typeId = pComponent->GetTypeData().id;
+    if (typeId < subscribers.size())
+    {
+        for (IWorldSystem* pSystem : subscribers[typeId])
+        {
+            pSystem->UnregisterComponent(pEntity, pComponent);
+        }
+    }
+
+    for (IWorldSystem* pSystem : unfilteredSystems)
+    {
+        pSystem->UnregisterComponent(pEntity, pComponent);
+    }
+}
+
+// ***********************************************************************
+
+void World::InsertEntity(Entity* pEntity)
+{
+    entityIndex[pEntity->GetId()] = entities.size();
+    entities.push_back(pEntity);
+}
+
+// ***********************************************************************
+
+void World::RemoveEntity(eastl::hash_map<Uuid, size_t>::iterator indexEntry)
+{
+    size_t slot = indexEntry->second;
+    entityIndex.erase(indexEntry);
+
+    if (slot != entities.size() - 1)
+    {
+        entities[slot] = entities.back();
+        entityIndex[entities[slot]->GetId()] = slot;
+    }
+    entities.pop_back();
+}
+
+// ***********************************************************************
+
 Entity* World::EntityIterator::operator*() const 
 { 
 	return *it;
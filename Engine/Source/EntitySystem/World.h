@@ -2,10 +2,14 @@
 
 #include "EASTL/string.h"
 #include "EASTL/vector.h"
+#include "EASTL/hash_map.h"
 #include "UUID.h"
+#include "Jobs.h"
+#include "TypeSystem.h"
 
 class Entity;
 class IWorldSystem;
+struct IComponent;
 struct UpdateContext;
 
 class World
@@ -16,6 +20,11 @@ public:
 	// This will create new element in array and return it to you.
 	Entity* NewEntity(eastl::string name);
 
+	// Hands over entities made elsewhere, like prefab instances, the world owns them from then on
+	// If the world is active they're registered with its systems together on the next update
+	void AddEntities(Entity** ppEntities, size_t count);
+
+	// The entity is removed and deleted at the start of the next update
 	void DestroyEntity(Uuid entityId);
 
 	// Registers things and turns everything on
@@ -24,15 +33,32 @@ public:
 	void DeactivateWorld();
 
 	// Loops through entities, updating them, then globals
+	// Global systems that don't conflict, going by their WorldSystemAccess, are updated at the same time on the job workers
+	// A system with nothing to run alongside it, like an exclusive one, is just updated on this thread
 	void OnUpdate(UpdateContext& ctx);
 
+	// When on, entity local systems (see IEntitySystem) of all entities are updated first, spread across the job workers,
+	// then each entity's other systems are updated serially, then the global systems. Off by default, since it
+	// changes the order systems within an entity are updated in. The order is the same however many entities or
+	// workers there are, small worlds and machines without workers just do the local updates on this thread
+	void SetParallelEntityUpdates(bool enable) { parallelEntityUpdates = enable; }
+
 	template<typename Type>
     IWorldSystem* AddGlobalSystem()
 	{
-    	globalSystems.push_back(new Type());
-		return globalSystems.back();
+		IWorldSystem* pSystem = new Type();
+    	globalSystems.push_back(pSystem);
+		AddSubscriber(pSystem);
+
+		SystemNode node;
+		node.pSystem = pSystem;
+		node.systemType = ::Type::Index<Type>();
+		systemNodes.push_back(node);
+		isScheduleDirty = true;
+		return pSystem;
 	}
 
+	// Only finds entities that have made it into the world, not ones still queued up to be added
 	Entity* FindEntity(Uuid entityId);
 
 	/**
@@ -67,11 +93,55 @@ public:
 	const EntityIterator end();
 
 private:
+	void AddSubscriber(IWorldSystem* pSystem);
+
+	// Passes the component on to just the global systems subscribed to its type
+	void RegisterWithSystems(Entity* pEntity, IComponent* pComponent);
+	void UnregisterWithSystems(Entity* pEntity, IComponent* pComponent);
+
+	// Local systems of every entity, then their shared systems, see SetParallelEntityUpdates
+	void UpdateEntitiesInParallel(UpdateContext& ctx);
+
+	// A global system's place in the update order, and the systems that have to wait for it
+	struct SystemNode
+	{
+		IWorldSystem* pSystem{ nullptr };
+		uint32_t systemType{ 0 };
+		eastl::vector<uint32_t> dependents;
+		int nDependencies{ 0 };
+
+		World* pWorld{ nullptr };
+		int nWaiting{ 0 }; // Dependencies not yet finished this update
+	};
+
+	// Works out the dependencies between global systems, done lazily since After can be set any time before the first update
+	void BuildSystemSchedule();
+	void UpdateGlobalSystems(UpdateContext& ctx);
+	static void UpdateSystemNode(void* pData);
+
+	void InsertEntity(Entity* pEntity);
+
+	// Swaps the last entity into the gap, so entities stay contiguous but don't keep their order
+	void RemoveEntity(eastl::hash_map<Uuid, size_t>::iterator indexEntry);
+
 	bool isActive{ false };
+	bool parallelEntityUpdates{ false };
 
 	eastl::vector<Entity*> entitiesToAddQueue;
-	eastl::vector<Entity*> entitiesToDeleteQueue;
+	eastl::vector<Uuid> entitiesToDeleteQueue;
 
 	eastl::vector<Entity*> entities;
+	eastl::hash_map<Uuid, size_t> entityIndex; // Entity id -> position in entities
 	eastl::vector<IWorldSystem*> globalSystems;
+
+	eastl::vector<SystemNode> systemNodes; // Same order as globalSystems
+	eastl::vector<uint32_t> serialSystemOrder; // For when there are no workers to spread systems across
+	bool isScheduleDirty{ false };
+	UpdateContext* pUpdateContext{ nullptr }; // Only valid while global systems are updating
+	Jobs::Counter systemsCounter;
+	eastl::vector<uint32_t> readySystems; // Systems free to update together on this step of the update
+	eastl::vector<uint32_t> nextReadySystems;
+
+	eastl::vector<eastl::vector<IWorldSystem*>> subscribers; // Indexed by TypeData id
+	eastl::vector<IWorldSystem*> unfilteredSystems; // Subscribed to nothing, so they're given every component
 };
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "SceneSerializer.h"
 #include "Json.h"
 #include "FileSystem.h"
+#include "FileStream.h"
 #include "AssetDatabase.h"
 #include "GraphicsDevice.h"
 #include "AppWindow.h"
@@ -279,8 +280,14 @@ TextureHandle Editor::DrawFrame(Scene& scene, UpdateContext& ctx)
 
 		if (ImGui::Button("Open", ImVec2(120, 0))) 
 		{
-			JsonValue jsonScene = ParseJsonFile(FileSys::ReadWholeFile(levelOpenModalFiles[selectedLevelFile]));
-			Scene* pScene = SceneSerializer::NewSceneFromJson(jsonScene);
+			// Levels may be json or binary, so read it as binary and check which
+			FileStream levelFile(levelOpenModalFiles[selectedLevelFile], FileRead | FileBinary);
+			eastl::string level = levelFile.Read(levelFile.Size());
+			Scene* pScene = nullptr;
+			if (SceneSerializer::IsBinary(level))
+				pScene = SceneSerializer::NewSceneFromBinary(level);
+			else
+				pScene = SceneSerializer::NewSceneFromJson(ParseJsonFile(level));
 			
 			// TODO: Fix at some point
 			//Engine::SetActiveWorld(pScene);
@@ -1,6 +1,7 @@
 #include "FrameStats.h"
 #include "Profiler.h"
 #include "Engine.h"
+#include "Scene.h"
 
 #include <Imgui/imgui.h>
 
@@ -44,5 +45,24 @@ void FrameStats::Update(Scene& scene, UpdateContext& ctx)
         ImGui::Text(str.c_str());
     }
 
+    ImGui::Separator();
+
+    ImGui::Text("Scene chunk memory %.1f KB committed, %i chunks in use (%i active entities)", scene.GetResidentBytes() / 1024.0, int(scene.nActiveChunks), scene.nActiveEntities);
+    for (ComponentPool* pPool : scene.componentPools)
+    {
+        if (pPool == nullptr || pPool->residentBytes == 0)
+            continue;
+        ImGui::Text("%s - %.1f KB", pPool->pTypeData->name, pPool->residentBytes / 1024.0);
+    }
+
+    ImGui::Separator();
+
+    for (SceneQuery* pQuery : scene.queries)
+    {
+        if (pQuery == nullptr)
+            continue;
+        ImGui::Text("Query <%s> - %i archetypes, %i entities, %.4fms maintenance", pQuery->name.c_str(), (int)pQuery->archetypes.size(), pQuery->CountEntities(), pQuery->GetMaintenanceMs());
+    }
+
     ImGui::End();
 }
\ No newline at end of file
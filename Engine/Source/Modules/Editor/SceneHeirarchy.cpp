@@ -27,7 +27,7 @@ void RecurseDrawEntityTree(UpdateContext& ctx, EntityID parent)
 	// 	if (!scene.Has<CParent>(currChild))
 	// 		nodeFlags = ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
 
-	// 	bool nodeOpened = ImGui::TreeNodeEx((void*)(uintptr_t)currChild.value, nodeFlags, "%i - %s", currChild.Index(), scene.GetEntityName(currChild).c_str());
+	// 	bool nodeOpened = ImGui::TreeNodeEx((void*)(uintptr_t)currChild.value, nodeFlags, "%i - %s", currChild.Index(), scene.GetEntityName(currChild));
 	// 	if (ImGui::IsItemClicked())
 	// 		Editor::SetSelectedEntity(currChild);
 		
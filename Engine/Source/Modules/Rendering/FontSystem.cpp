@@ -33,6 +33,14 @@ FT_Library* FreeType::Get()
 
 // ***********************************************************************
 
+FontDrawSystem::FontDrawSystem()
+{
+	subscriptions.Subscribe<TextComponent>();
+	access.UpdatesNothing();
+}
+
+// ***********************************************************************
+
 void FontDrawSystem::Activate()
 {
 	GameRenderer::RegisterRenderSystemTransparent(this);
@@ -113,7 +121,7 @@ void FontDrawSystem::RegisterComponent(Entity* pEntity, IComponent* pComponent)
 {
 	if (pComponent->GetTypeData() == TypeDatabase::Get<TextComponent>())
 	{
-		textComponents.push_back(static_cast<TextComponent*>(pComponent));
+		textComponents.Add(static_cast<TextComponent*>(pComponent));
 	}
 }
 
@@ -121,10 +129,9 @@ void FontDrawSystem::RegisterComponent(Entity* pEntity, IComponent* pComponent)
 
 void FontDrawSystem::UnregisterComponent(Entity* pEntity, IComponent* pComponent)
 {
-	eastl::vector<TextComponent*>::iterator found = eastl::find(textComponents.begin(), textComponents.end(), pComponent);
-	if (found != textComponents.end())
+	if (pComponent->GetTypeData() == TypeDatabase::Get<TextComponent>())
 	{
-		textComponents.erase(found);
+		textComponents.Remove(static_cast<TextComponent*>(pComponent));
 	}
 }
 
@@ -155,6 +162,8 @@ void FontDrawSystem::Draw(UpdateContext& ctx, FrameContext& frameCtx)
 	GfxDevice::SetBlending(blendState);
 	GfxDevice::BindSampler(charTextureSampler, ShaderType::Pixel, 0);
 
+	// Text is blended, so it has to be drawn in the order it was made
+	textComponents.RestoreOrder();
 	for(TextComponent* pText : textComponents)
 	{
 		if (!pText->visible)
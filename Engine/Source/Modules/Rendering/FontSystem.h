@@ -9,6 +9,7 @@
 
 #include "Systems.h"
 #include "SpatialComponent.h"
+#include "RegisteredComponents.h"
 
 #include <EASTL/vector.h>
 #include <EASTL/string.h>
@@ -43,6 +44,7 @@ namespace FreeType
 
 struct FontDrawSystem : public IWorldSystem
 {
+	FontDrawSystem();
 	~FontDrawSystem();
 
     virtual void Activate() override;
@@ -58,7 +60,7 @@ struct FontDrawSystem : public IWorldSystem
 	static FT_Library GetFreeType();
 
 private:
-	eastl::vector<TextComponent*> textComponents;
+	RegisteredComponents<TextComponent> textComponents;
 
 	ProgramHandle fontShaderProgram;
 	ConstBufferHandle constBuffer;
@@ -53,6 +53,12 @@ void RestartEmitter(ParticleEmitter& emitter)
 	}
 }
 
+ParticlesSystem::ParticlesSystem()
+{
+	subscriptions.Subscribe<ParticleEmitter>();
+	access.UpdatesNothing();
+}
+
 ParticlesSystem::~ParticlesSystem()
 {
 	GameRenderer::UnregisterRenderSystemOpaque(this);
@@ -88,6 +88,7 @@ struct ParticleEmitter : public SpatialComponent
 
 struct ParticlesSystem : public IWorldSystem
 {
+	ParticlesSystem();
 	~ParticlesSystem();
 
     virtual void Activate() override;
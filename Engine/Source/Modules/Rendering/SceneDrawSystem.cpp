@@ -21,6 +21,12 @@ REFLECT_MEMBER(shaderHandle)
 REFLECT_MEMBER(meshHandle)
 REFLECT_END()
 
+SceneDrawSystem::SceneDrawSystem()
+{
+	subscriptions.Subscribe<Renderable>();
+	access.UpdatesNothing();
+}
+
 SceneDrawSystem::~SceneDrawSystem()
 {
 	GameRenderer::UnregisterRenderSystemOpaque(this);
@@ -41,16 +47,15 @@ void SceneDrawSystem::RegisterComponent(Entity* pEntity, IComponent* pComponent)
 {
 	if (pComponent->GetTypeData() == TypeDatabase::Get<Renderable>())
 	{
-		renderableComponents.push_back(static_cast<Renderable*>(pComponent));
+		renderableComponents.Add(static_cast<Renderable*>(pComponent));
 	}
 }
 
 void SceneDrawSystem::UnregisterComponent(Entity* pEntity, IComponent* pComponent)
 {
-	eastl::vector<Renderable*>::iterator found = eastl::find(renderableComponents.begin(), renderableComponents.end(), pComponent);
-	if (found != renderableComponents.end())
+	if (pComponent->GetTypeData() == TypeDatabase::Get<Renderable>())
 	{
-		renderableComponents.erase(found);
+		renderableComponents.Remove(static_cast<Renderable*>(pComponent));
 	}
 }
 void SceneDrawSystem::Draw(UpdateContext& ctx, FrameContext& frameCtx)
@@ -6,6 +6,7 @@
 #include "Systems.h"
 #include "Entity.h"
 #include "SpatialComponent.h"
+#include "RegisteredComponents.h"
 
 struct IComponent;
 
@@ -24,6 +25,7 @@ struct Renderable : public SpatialComponent
 
 struct SceneDrawSystem : public IWorldSystem
 {
+	SceneDrawSystem();
 	~SceneDrawSystem();
 
     virtual void Activate() override;
@@ -36,5 +38,5 @@ struct SceneDrawSystem : public IWorldSystem
 
 	virtual void Draw(UpdateContext& ctx, FrameContext& frameCtx) override;
 
-	eastl::vector<Renderable*> renderableComponents;
+	RegisteredComponents<Renderable> renderableComponents;
 };
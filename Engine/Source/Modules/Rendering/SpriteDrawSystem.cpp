@@ -17,6 +17,14 @@ REFLECT_END()
 
 // ***********************************************************************
 
+SpriteDrawSystem::SpriteDrawSystem()
+{
+    subscriptions.Subscribe<Sprite>();
+    access.UpdatesNothing();
+}
+
+// ***********************************************************************
+
 void SpriteDrawSystem::Activate()
 {
     GameRenderer::RegisterRenderSystemTransparent(this);
@@ -73,7 +81,7 @@ void SpriteDrawSystem::RegisterComponent(Entity* pEntity, IComponent* pComponent
 {
     if (pComponent->GetTypeData() == TypeDatabase::Get<Sprite>())
 	{
-		spriteComponents.push_back(static_cast<Sprite*>(pComponent));
+		spriteComponents.Add(static_cast<Sprite*>(pComponent));
 	}
 }
 
@@ -81,10 +89,9 @@ void SpriteDrawSystem::RegisterComponent(Entity* pEntity, IComponent* pComponent
 
 void SpriteDrawSystem::UnregisterComponent(Entity* pEntity, IComponent* pComponent)
 {
-    eastl::vector<Sprite*>::iterator found = eastl::find(spriteComponents.begin(), spriteComponents.end(), pComponent);
-	if (found != spriteComponents.end())
+    if (pComponent->GetTypeData() == TypeDatabase::Get<Sprite>())
 	{
-		spriteComponents.erase(found);
+		spriteComponents.Remove(static_cast<Sprite*>(pComponent));
 	}
 }
 
@@ -103,6 +110,8 @@ void SpriteDrawSystem::Draw(UpdateContext& ctx, FrameContext& frameCtx)
 	GfxDevice::SetBlending(blendState);
 	GfxDevice::BindSampler(spriteSampler, ShaderType::Pixel, 0);
     
+    // Sprites are blended, so they have to be drawn in the order they were made
+    spriteComponents.RestoreOrder();
     for (Sprite* pSprite : spriteComponents)
     {
         Image* pImage = AssetDB::GetAsset<Image>(pSprite->spriteHandle);
@@ -5,6 +5,7 @@
 
 #include "Systems.h"
 #include "SpatialComponent.h"
+#include "RegisteredComponents.h"
 #include "Mesh.h"
 
 struct Scene;
@@ -21,6 +22,7 @@ struct Sprite : public SpatialComponent
 
 struct SpriteDrawSystem : public IWorldSystem
 {
+    SpriteDrawSystem();
     ~SpriteDrawSystem();
 
     virtual void Activate() override;
@@ -43,5 +45,5 @@ private:
 
     Primitive quadPrim;
 
-	eastl::vector<Sprite*> spriteComponents;
+	RegisteredComponents<Sprite> spriteComponents;
 };
@@ -25,6 +25,7 @@
 #include <Variant.h>
 
 #include <World.h>
+#include <Prefab.h>
 #include <Systems.h>
 #include <Rendering/SceneDrawSystem.h>
 
@@ -99,6 +100,24 @@ eastl::fixed_vector<Vec2f, 15> GetRandomAsteroidMesh()
 	return vec;
 }
 
+Prefab& GetAsteroidPrefab()
+{
+	// Made on first use and never freed, so nothing depends on when statics are destroyed at exit
+	static Prefab* pPrefab = nullptr;
+	if (pPrefab == nullptr)
+	{
+		pPrefab = new Prefab("Asteroid");
+		pPrefab->AddNewComponent<AsteroidComponent>();
+
+		AsteroidPhysics* pPhysics = pPrefab->AddNewComponent<AsteroidPhysics>();
+		pPhysics->SetLocalScale(Vec3f(90.0f, 90.0f, 1.0f));
+		pPhysics->collisionRadius = 40.0f;
+
+		pPrefab->AddNewComponent<Polyline>(pPhysics->GetId());
+	}
+	return *pPrefab;
+}
+
 World* CreateMainAsteroidsScene()
 {
 	World& world = *(new World());
@@ -158,24 +177,20 @@ World* CreateMainAsteroidsScene()
 	}
 
 	// Create some asteroids
-	for (int i = 0; i < 10; i++)
+	Entity* asteroids[10];
+	GetAsteroidPrefab().Instantiate(world, 10, asteroids);
+	for (Entity* pAsteroid : asteroids)
 	{
 		Vec3f randomLocation = Vec3f(float(rand() % 1800), float(rand() % 1000), 0.0f);
 		Vec3f randomVelocity = Vec3f(randf() * 2.0f - 1.0f, randf() * 2.0f - 1.0f, 0.0f)  * 40.0f;
 		float randomRotation = randf() * 6.282f;
 
-		Entity* pAsteroid = world.NewEntity("Asteroid");
-		AsteroidComponent* pTemp = pAsteroid->AddNewComponent<AsteroidComponent>();
-
-		AsteroidPhysics* pPhysics = pAsteroid->AddNewComponent<AsteroidPhysics>();
+		AsteroidPhysics* pPhysics = pAsteroid->GetComponent<AsteroidPhysics>();
 		pPhysics->velocity = randomVelocity;
 		pPhysics->SetLocalPosition(randomLocation);
-		pPhysics->SetLocalScale(Vec3f(90.0f, 90.0f, 1.0f));
 		pPhysics->SetLocalRotation(Vec3f(0.0f, 0.0f, randomRotation));
-		pPhysics->collisionRadius = 40.0f;
 
-		Polyline* pAsteroidPoly = pAsteroid->AddNewComponent<Polyline>(pPhysics->GetId());
-		pAsteroidPoly->points = GetRandomAsteroidMesh();
+		pAsteroid->GetComponent<Polyline>()->points = GetRandomAsteroidMesh();
 	}
 
 	// Create the UI entity
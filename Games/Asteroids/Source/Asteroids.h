@@ -4,7 +4,13 @@
 
 #define PLAYER_ID EntityID{ 0 }
 
+class Prefab;
+
 void LoadMainScene();
 void LoadMenu();
 
-eastl::fixed_vector<Vec2f, 15> GetRandomAsteroidMesh();
\ No newline at end of file
+eastl::fixed_vector<Vec2f, 15> GetRandomAsteroidMesh();
+
+// A full size asteroid, position, velocity, rotation and mesh are left for each instance to pick
+// Built the first time it's asked for, everything that spawns asteroids instantiates this one
+Prefab& GetAsteroidPrefab();
\ No newline at end of file
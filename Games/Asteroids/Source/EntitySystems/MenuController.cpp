@@ -7,6 +7,12 @@
 #include "../Components.h"
 #include "../Asteroids.h"
 
+MenuController::MenuController()
+{
+    subscriptions.Subscribe<Polyline>();
+    subscriptions.Subscribe<MenuCursorComponent>();
+}
+
 void MenuController::Activate()
 {
     
@@ -10,6 +10,8 @@ struct Polyline;
 
 struct MenuController : public IEntitySystem
 {
+    MenuController();
+
     virtual void Activate() override;
 
 	virtual void RegisterComponent(IComponent* pComponent) override;
@@ -19,6 +21,6 @@ struct MenuController : public IEntitySystem
 	virtual void Update(UpdateContext& ctx) override;
 
 private:
-    MenuCursorComponent* pCursor;
-    Polyline* pGraphics;
+    MenuCursorComponent* pCursor{ nullptr };
+    Polyline* pGraphics{ nullptr };
 };
\ No newline at end of file
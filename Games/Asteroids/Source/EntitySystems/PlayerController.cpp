@@ -9,6 +9,12 @@
 #include "../Asteroids.h"
 #include "../Components.h"
 
+PlayerController::PlayerController()
+{
+    subscriptions.Subscribe<AsteroidPhysics>();
+    subscriptions.Subscribe<PlayerComponent>();
+}
+
 void PlayerController::Activate()
 {
 
@@ -10,6 +10,8 @@ struct PlayerComponent;
 
 struct PlayerController : public IEntitySystem
 {
+    PlayerController();
+
     virtual void Activate() override;
 
 	virtual void RegisterComponent(IComponent* pComponent) override;
@@ -21,6 +23,6 @@ struct PlayerController : public IEntitySystem
 	void SpawnBullet(World* pWorld);
 
 private:
-    AsteroidPhysics* pRootPhysics;
-    PlayerComponent* pPlayerComponent;
+    AsteroidPhysics* pRootPhysics{ nullptr };
+    PlayerComponent* pPlayerComponent{ nullptr };
 };
\ No newline at end of file
@@ -6,6 +6,13 @@
 
 #include "../Components.h"
 
+PlayerDeathSystem::PlayerDeathSystem()
+{
+    subscriptions.Subscribe<PlayerComponent>();
+    subscriptions.Subscribe<AsteroidPhysics>();
+    subscriptions.Subscribe<Polyline>();
+}
+
 void PlayerDeathSystem::Activate()
 {
 
@@ -14,6 +14,8 @@ struct Polyline;
 
 struct PlayerDeathSystem : public IEntitySystem
 {
+    PlayerDeathSystem();
+
     virtual void Activate() override;
 
 	virtual void RegisterComponent(IComponent* pComponent) override;
@@ -23,8 +25,8 @@ struct PlayerDeathSystem : public IEntitySystem
 	virtual void Update(UpdateContext& ctx) override;
 
 private:
-    PlayerComponent* pPlayerComponent;
-    AsteroidPhysics* pPlayerPhysics;
+    PlayerComponent* pPlayerComponent{ nullptr };
+    AsteroidPhysics* pPlayerPhysics{ nullptr };
 
     eastl::map<Uuid, Polyline*> polylineComponents;
 };
\ No newline at end of file
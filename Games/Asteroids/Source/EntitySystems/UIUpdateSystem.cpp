@@ -2,6 +2,15 @@
 
 #include "../Components.h"
 
+UIUpdateSystem::UIUpdateSystem()
+{
+    subscriptions.Subscribe<TextComponent>();
+    subscriptions.Subscribe<Score>();
+
+    // Only ever writes to its own entity's text
+    isEntityLocal = true;
+}
+
 void UIUpdateSystem::Activate()
 {
 
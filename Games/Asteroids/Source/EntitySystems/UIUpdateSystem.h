@@ -11,6 +11,8 @@ class World;
 
 struct UIUpdateSystem : public IEntitySystem
 {
+    UIUpdateSystem();
+
     virtual void Activate() override;
 
 	virtual void RegisterComponent(IComponent* pComponent) override;
@@ -22,5 +24,5 @@ struct UIUpdateSystem : public IEntitySystem
 private:
 	eastl::map<Uuid, TextComponent*> textElements;
 
-    Score* pScoreComponent;
+    Score* pScoreComponent{ nullptr };
 };
\ No newline at end of file
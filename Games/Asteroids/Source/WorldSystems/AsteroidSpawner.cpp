@@ -5,11 +5,18 @@
 #include <Engine.h>
 #include <Rendering/GameRenderer.h>
 #include <World.h>
+#include <Prefab.h>
 #include <Engine.h>
 
 #include "../Components.h"
 #include "../Asteroids.h" 
 
+AsteroidSpawner::AsteroidSpawner()
+{
+    subscriptions.Subscribe<PlayerComponent>();
+    subscriptions.Subscribe<AsteroidSpawnData>();
+    access.Reads<PlayerComponent>().Writes<AsteroidSpawnData>().ChangesEntities();
+}
 
 void AsteroidSpawner::RegisterComponent(Entity* pEntity, IComponent* pComponent)
 {
@@ -82,17 +89,14 @@ void AsteroidSpawner::Update(UpdateContext& ctx)
 
         Log::Debug("Spawned asteroid");
 
-		Entity* pAsteroid = ctx.pWorld->NewEntity("Asteroid");
-		AsteroidComponent* pTemp = pAsteroid->AddNewComponent<AsteroidComponent>();
+		Entity* pAsteroid;
+		GetAsteroidPrefab().Instantiate(*ctx.pWorld, 1, &pAsteroid);
 
-		AsteroidPhysics* pPhysics = pAsteroid->AddNewComponent<AsteroidPhysics>();
+		AsteroidPhysics* pPhysics = pAsteroid->GetComponent<AsteroidPhysics>();
 		pPhysics->velocity = randomVelocity * 60.0f;
 		pPhysics->SetLocalPosition(randomLocation);
-		pPhysics->SetLocalScale(Vec3f(90.0f, 90.0f, 1.0f));
 		pPhysics->SetLocalRotation(Vec3f(0.0f, 0.0f, randf() * 6.282f));
-		pPhysics->collisionRadius = 40.0f;
 
-		Polyline* pAsteroidPoly = pAsteroid->AddNewComponent<Polyline>(pPhysics->GetId());
-		pAsteroidPoly->points = GetRandomAsteroidMesh();
+		pAsteroid->GetComponent<Polyline>()->points = GetRandomAsteroidMesh();
     }
 }
\ No newline at end of file
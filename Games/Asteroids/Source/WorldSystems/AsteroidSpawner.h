@@ -9,6 +9,8 @@ struct PlayerComponent;
 
 struct AsteroidSpawner : public IWorldSystem
 {
+    AsteroidSpawner();
+
     virtual void Activate() override {}
 
     virtual void Deactivate() override {}
@@ -20,6 +22,6 @@ struct AsteroidSpawner : public IWorldSystem
 	virtual void Update(UpdateContext& ctx) override;
 
 private:
-    AsteroidSpawnData* pSpawnData;
-    PlayerComponent* pPlayer;
+    AsteroidSpawnData* pSpawnData{ nullptr };
+    PlayerComponent* pPlayer{ nullptr };
 };
\ No newline at end of file
@@ -2,12 +2,22 @@
 
 #include <Engine.h>
 #include <World.h>
+#include <Prefab.h>
 #include <Rendering/ParticlesSystem.h>
 
 #include "../EntitySystems/PlayerController.h"
 #include "../Components.h"
 #include "../Asteroids.h"
 
+CollisionSystem::CollisionSystem()
+{
+    subscriptions.Subscribe<AsteroidPhysics>();
+    subscriptions.Subscribe<AsteroidComponent>();
+    subscriptions.Subscribe<PlayerComponent>();
+    subscriptions.Subscribe<Score>();
+    access.Reads<AsteroidPhysics>().Writes<AsteroidComponent, PlayerComponent, Score>().ChangesEntities();
+}
+
 void CollisionSystem::Activate()
 {
 
@@ -24,7 +34,7 @@ void CollisionSystem::RegisterComponent(Entity* pEntity, IComponent* pComponent)
             asteroidPhysics[pEntity->GetId()] = pPhysics;
             break;
         case CollisionType::Bullet:
-            bullets.push_back(pPhysics);
+            bullets.Add(pPhysics);
             break;
         case CollisionType::Player:
             pPlayerPhysics = pPhysics;
@@ -53,16 +63,13 @@ void CollisionSystem::UnregisterComponent(Entity* pEntity, IComponent* pComponen
     if (pComponent->GetTypeData() == TypeDatabase::Get<AsteroidPhysics>())
 	{
         AsteroidPhysics* pPhysics = static_cast<AsteroidPhysics*>(pComponent);
-        eastl::vector<AsteroidPhysics*>::iterator found;
         switch (pPhysics->type)
         {
         case CollisionType::Asteroid:
             asteroidPhysics.erase(pEntity->GetId());
             break;
         case CollisionType::Bullet:
-            found = eastl::find(bullets.begin(), bullets.end(), pPhysics);
-            if (found != bullets.end())
-                bullets.erase(found);
+            bullets.Remove(pPhysics);
             break;
         case CollisionType::Player:
             pPlayerPhysics = nullptr;
@@ -146,26 +153,24 @@ void CollisionSystem::OnBulletAsteroidCollision(World& world, Uuid bulletEntity,
         return;
     }
 
-    for (int i = 0; i < 2; i++)
+    Entity* newAsteroids[2];
+    GetAsteroidPrefab().Instantiate(world, 2, newAsteroids);
+    for (Entity* pNewAsteroid : newAsteroids)
 	{
 		auto randf = []() { return float(rand()) / float(RAND_MAX); };
 		float randomRotation = randf() * 6.282f;
 
 		Vec3f randomVelocity = pAsteroidPhysics->velocity + Vec3f(randf() * 2.0f - 1.0f, randf() * 2.0f - 1.0f, 0.0f) * 80.0f;
 
-		Entity* pNewAsteroid = world.NewEntity("Asteroid");
-		AsteroidComponent* pTemp = pNewAsteroid->AddNewComponent<AsteroidComponent>();
-        pTemp->hitCount = pAsteroidComponent->hitCount + 1;
+        pNewAsteroid->GetComponent<AsteroidComponent>()->hitCount = pAsteroidComponent->hitCount + 1;
 
-		AsteroidPhysics* pPhysics = pNewAsteroid->AddNewComponent<AsteroidPhysics>();
+		AsteroidPhysics* pPhysics = pNewAsteroid->GetComponent<AsteroidPhysics>();
 		pPhysics->velocity = randomVelocity;
 		pPhysics->SetLocalPosition(pAsteroidPhysics->GetLocalPosition());
 		pPhysics->SetLocalScale(pAsteroidPhysics->GetLocalScale() * 0.5f);
 		pPhysics->SetLocalRotation(Vec3f(0.0f, 0.0f, randomRotation));
-		pPhysics->collisionRadius = 40.0f;
 
-		Polyline* pAsteroidPoly = pNewAsteroid->AddNewComponent<Polyline>(pPhysics->GetId());
-		pAsteroidPoly->points = GetRandomAsteroidMesh();
+		pNewAsteroid->GetComponent<Polyline>()->points = GetRandomAsteroidMesh();
 	}
 
     // 6. Destroy this asteroid and the bullet
@@ -5,6 +5,7 @@
 #include <SpatialComponent.h>
 #include <Entity.h>
 #include <Systems.h>
+#include <RegisteredComponents.h>
 
 struct AsteroidPhysics;
 struct AsteroidComponent;
@@ -16,6 +17,8 @@ class World;
 
 struct CollisionSystem : public IWorldSystem
 {
+    CollisionSystem();
+
     virtual void Activate() override;
 
     virtual void Deactivate() override {}
@@ -33,10 +36,10 @@ private:
 	eastl::map<Uuid, AsteroidPhysics*> asteroidPhysics;
 	eastl::map<Uuid, AsteroidComponent*> asteroids;
 
-    eastl::vector<AsteroidPhysics*> bullets;
+    RegisteredComponents<AsteroidPhysics> bullets;
 
-	AsteroidPhysics* pPlayerPhysics;
-	PlayerComponent* pPlayerComponent;
+	AsteroidPhysics* pPlayerPhysics{ nullptr };
+	PlayerComponent* pPlayerComponent{ nullptr };
 
-	Score* pScoreComponent;
+	Score* pScoreComponent{ nullptr };
 };
\ No newline at end of file
@@ -4,6 +4,12 @@
 #include <Rendering/GameRenderer.h>
 #include "World.h"
 
+MovementSystem::MovementSystem()
+{
+    subscriptions.Subscribe<AsteroidPhysics>();
+    access.Writes<AsteroidPhysics>().ChangesEntities();
+}
+
 void MovementSystem::Activate()
 {
 
@@ -13,25 +19,23 @@ void MovementSystem::RegisterComponent(Entity* pEntity, IComponent* pComponent)
 {
     if (pComponent->GetTypeData() == TypeDatabase::Get<AsteroidPhysics>())
 	{
-		physicsComponents.push_back(PhysicsComponent(pEntity, static_cast<AsteroidPhysics*>(pComponent)));
+		physicsComponents.Add(static_cast<AsteroidPhysics*>(pComponent));
 	}
 }
 
 void MovementSystem::UnregisterComponent(Entity* pEntity, IComponent* pComponent)
 {
-    eastl::vector<PhysicsComponent>::iterator found = eastl::find(physicsComponents.begin(), physicsComponents.end(), PhysicsComponent(pEntity, static_cast<AsteroidPhysics*>(pComponent)));
-	if (found != physicsComponents.end())
+    if (pComponent->GetTypeData() == TypeDatabase::Get<AsteroidPhysics>())
 	{
-		physicsComponents.erase(found);
+		physicsComponents.Remove(static_cast<AsteroidPhysics*>(pComponent));
 	}
 }
 
 void MovementSystem::Update(UpdateContext& ctx)
 {
-    for (PhysicsComponent compPair : physicsComponents)
+    for (AsteroidPhysics* pPhysics : physicsComponents)
     {
-		Uuid entityId = compPair.first->GetId();
-		AsteroidPhysics* pPhysics = compPair.second;
+		Uuid entityId = pPhysics->GetEntityId();
 		pPhysics->velocity = pPhysics->velocity + pPhysics->acceleration * ctx.deltaTime;
 		pPhysics->SetLocalPosition(pPhysics->GetLocalPosition() + pPhysics->velocity * ctx.deltaTime);
 
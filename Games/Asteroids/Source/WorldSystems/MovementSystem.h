@@ -5,6 +5,7 @@
 #include <SpatialComponent.h>
 #include <Entity.h>
 #include <Systems.h>
+#include <RegisteredComponents.h>
 
 #include "../Components.h"
 
@@ -12,6 +13,8 @@ struct UpdateContext;
 
 struct MovementSystem : public IWorldSystem
 {
+    MovementSystem();
+
     virtual void Activate() override;
 
     virtual void Deactivate() override {}
@@ -23,7 +26,5 @@ struct MovementSystem : public IWorldSystem
 	virtual void Update(UpdateContext& ctx) override;
 
 private:
-
-	using PhysicsComponent = eastl::pair<Entity*, AsteroidPhysics*>;
-    eastl::vector<PhysicsComponent> physicsComponents;
+    RegisteredComponents<AsteroidPhysics> physicsComponents;
 };
\ No newline at end of file
@@ -70,6 +70,14 @@ void PolylineDrawSystem::AddPolyLine(const VertsVector& verts, float thickness,
 
 // ***********************************************************************
 
+PolylineDrawSystem::PolylineDrawSystem()
+{
+	subscriptions.Subscribe<Polyline>();
+	access.UpdatesNothing();
+}
+
+// ***********************************************************************
+
 void PolylineDrawSystem::Activate()
 {
 	GameRenderer::RegisterRenderSystemOpaque(this);
@@ -125,7 +133,7 @@ void PolylineDrawSystem::RegisterComponent(Entity* pEntity, IComponent* pCompone
 {
 	if (pComponent->GetTypeData() == TypeDatabase::Get<Polyline>())
 	{
-		polylineComponents.push_back(static_cast<Polyline*>(pComponent));
+		polylineComponents.Add(static_cast<Polyline*>(pComponent));
 	}
 }
 
@@ -133,10 +141,9 @@ void PolylineDrawSystem::RegisterComponent(Entity* pEntity, IComponent* pCompone
 
 void PolylineDrawSystem::UnregisterComponent(Entity* pEntity, IComponent* pComponent)
 {
-	eastl::vector<Polyline*>::iterator found = eastl::find(polylineComponents.begin(), polylineComponents.end(), pComponent);
-	if (found != polylineComponents.end())
+	if (pComponent->GetTypeData() == TypeDatabase::Get<Polyline>())
 	{
-		polylineComponents.erase(found);
+		polylineComponents.Remove(static_cast<Polyline*>(pComponent));
 	}
 }
 
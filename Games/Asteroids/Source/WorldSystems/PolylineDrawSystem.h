@@ -8,6 +8,7 @@
 #include <Systems.h>
 #include <Entity.h>
 #include <SpatialComponent.h>
+#include <RegisteredComponents.h>
 
 typedef eastl::fixed_vector<Vec2f, 50> VertsVector;
 struct FrameContext;
@@ -16,6 +17,7 @@ struct Polyline;
 
 struct PolylineDrawSystem : public IWorldSystem
 {
+	PolylineDrawSystem();
 	~PolylineDrawSystem();
 
     virtual void Activate() override;
@@ -31,7 +33,7 @@ struct PolylineDrawSystem : public IWorldSystem
 private:
 	void AddPolyLine(const VertsVector& verts, float thickness, Vec4f color, bool connected);
 
-	eastl::vector<Polyline*> polylineComponents;
+	RegisteredComponents<Polyline> polylineComponents;
 
 	struct DrawCall
 	{
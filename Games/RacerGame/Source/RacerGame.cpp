@@ -27,11 +27,8 @@ void CameraControlSystem(Scene& scene, float deltaTime)
 {
 	PROFILE();
 
-	for (EntityID cams : SceneIterator<CCamera, CTransform>(scene))
+	scene.ParallelForEach<CCamera, CTransform>([deltaTime](EntityID cam, CCamera* pCam, CTransform* pTrans)
 	{
-		CCamera* pCam = scene.Get<CCamera>(cams);
-		CTransform* pTrans = scene.Get<CTransform>(cams);
-
 		const float camSpeed = 5.0f;
 
 		Matrixf toCameraSpace = Quatf::MakeFromEuler(pTrans->localRot).ToMatrix();
@@ -59,7 +56,7 @@ void CameraControlSystem(Scene& scene, float deltaTime)
 			pCam->verticalAngle -= 0.1f * deltaTime * Input::GetMouseDelta().y;
 		}
 		pTrans->localRot = Vec3f(pCam->verticalAngle, pCam->horizontalAngle, 0.0f);
-	}
+	});
 }
 
 
@@ -133,7 +130,7 @@ int main(int argc, char *argv[])
 
 	// Register systems
 	Engine::SetSceneCreateCallback([](Scene& newScene) {
-		newScene.RegisterSystem(SystemPhase::Update, CameraControlSystem);
+		newScene.RegisterSystem(SystemPhase::Update, CameraControlSystem, SystemAccess().Writes<CCamera, CTransform>());
 	});
 
 	// Run everything
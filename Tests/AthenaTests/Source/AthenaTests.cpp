@@ -0,0 +1,33 @@
+#include "Test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+void RegisterCoreTests();
+void RegisterSceneTests();
+void RegisterWorldTests();
+
+// Usage: AthenaTests [--filter name]
+int main(int argc, char* argv[])
+{
+	const char* filter = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+		{
+			filter = argv[++i];
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [--filter name]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	RegisterCoreTests();
+	RegisterSceneTests();
+	RegisterWorldTests();
+
+	return Test::RunAll(filter) == 0 ? 0 : 1;
+}
@@ -0,0 +1,54 @@
+#include "Test.h"
+
+#include <VirtualArena.h>
+
+#include <string.h>
+
+// ***********************************************************************
+
+// Decommitting memory that doesn't line up with pages only gives back the pages wholly inside it,
+// so neighbouring allocations sharing the pages at either end keep their contents
+void Test_ArenaDecommitsWholePagesOnly()
+{
+	size_t pageSize = VirtualArena::PageSize();
+	VirtualArena arena;
+	char* pMemory = static_cast<char*>(arena.Allocate(pageSize * 4));
+	memset(pMemory, 0xab, pageSize * 4);
+	size_t committedBytes = arena.GetCommittedBytes();
+
+	// Less than a page, nothing can go
+	arena.Decommit(pMemory + 64, pageSize / 2);
+	CHECK(arena.GetCommittedBytes() == committedBytes);
+	CHECK(pMemory[64] == char(0xab));
+
+	// Straddles three pages but only covers the middle one
+	arena.Decommit(pMemory + pageSize / 2, pageSize * 2);
+	CHECK(arena.GetCommittedBytes() == committedBytes - pageSize);
+	CHECK(pMemory[pageSize / 2] == char(0xab));
+	CHECK(pMemory[pageSize * 2 + pageSize / 2 - 1] == char(0xab));
+
+	arena.Recommit(pMemory + pageSize / 2, pageSize * 2);
+	CHECK(arena.GetCommittedBytes() == committedBytes);
+	CHECK(pMemory[pageSize / 2] == char(0xab));
+	pMemory[pageSize] = 1;
+	CHECK(pMemory[pageSize] == 1);
+}
+
+// ***********************************************************************
+
+// The arena commits in steps of whole pages, whatever the page size
+void Test_ArenaCommitsWholePages()
+{
+	VirtualArena arena;
+	arena.Allocate(1);
+	CHECK(arena.GetCommittedBytes() > 0);
+	CHECK(arena.GetCommittedBytes() % VirtualArena::PageSize() == 0);
+}
+
+// ***********************************************************************
+
+void RegisterCoreTests()
+{
+	Test::Register("ArenaDecommitsWholePagesOnly", Test_ArenaDecommitsWholePagesOnly);
+	Test::Register("ArenaCommitsWholePages", Test_ArenaCommitsWholePages);
+}
@@ -0,0 +1,209 @@
+#include "Test.h"
+
+#include <Scene.h>
+#include <EntityCommandBuffer.h>
+#include <SceneSerializer.h>
+
+#include <string.h>
+
+namespace
+{
+	size_t g_nBatchAdded = 0;
+	size_t g_nBatchRemoved = 0;
+
+	void CountBatchAdded(Scene& scene, const EntityID* pIds, size_t count)
+	{
+		g_nBatchAdded += count;
+	}
+
+	void CountBatchRemoved(Scene& scene, const EntityID* pIds, size_t count)
+	{
+		g_nBatchRemoved += count;
+	}
+
+	// A binary scene of entities that only have a CTransform, with no free slots, so the layout is known
+	// The header, then the one entry type table, the empty free list, and the block's column count, type and entity count
+	const size_t BINARY_ENTITY_COUNT_OFFSET = 3 * sizeof(uint32_t);
+	const size_t BINARY_INDICES_OFFSET = 5 * sizeof(uint32_t) + (sizeof(uint32_t) + strlen("CTransform") + 9) + sizeof(uint32_t) + 3 * sizeof(uint32_t);
+
+	eastl::string TransformsToBinary(int count)
+	{
+		Scene scene;
+		scene.NewEntities<CTransform>(uint32_t(count));
+		return SceneSerializer::ToBinary(scene);
+	}
+
+	void PatchIndex(eastl::string& data, size_t offset, EntityIndex index)
+	{
+		memcpy(&data[offset], &index, sizeof(index));
+	}
+}
+
+// ***********************************************************************
+
+// Entities made through a command buffer should end up just like ones made on the scene directly
+void Test_CommandBufferNewEntity()
+{
+	Scene scene;
+	EntityID direct = scene.NewEntity(nullptr);
+	EntityID directNamed = scene.NewEntity("Named");
+
+	EntityCommandBuffer commands(scene);
+	CHECK(commands.NewEntity().Version() == PENDING_ENTITY_VERSION);
+	commands.NewEntity(nullptr);
+	commands.NewEntity("Named");
+	commands.Playback();
+
+	// Playback makes the pending entities in the order they were recorded, after the ones already there
+	EntityID buffered = scene.entities[2].id;
+	EntityID bufferedNull = scene.entities[3].id;
+	EntityID bufferedNamed = scene.entities[4].id;
+	CHECK(scene.nActiveEntities == 5);
+
+	CHECK(scene.entities[buffered.Index()].pArchetype == scene.entities[direct.Index()].pArchetype);
+	CHECK(scene.entities[bufferedNull.Index()].pArchetype == scene.entities[direct.Index()].pArchetype);
+	CHECK(scene.entities[bufferedNamed.Index()].pArchetype == scene.entities[directNamed.Index()].pArchetype);
+	CHECK(!scene.Has<CName>(buffered));
+	CHECK(!scene.Has<CName>(bufferedNull));
+	CHECK(strcmp(scene.GetEntityName(buffered), scene.GetEntityName(direct)) == 0);
+
+#if ATHENA_ENTITY_NAMES
+	CHECK(scene.Has<CName>(bufferedNamed));
+	CHECK(strcmp(scene.GetEntityName(bufferedNamed), "Named") == 0);
+
+	// Unnamed entities mustn't be findable under an empty name
+	CHECK(!scene.FindEntity("").IsValid());
+	CHECK(scene.FindEntity("Named") == directNamed);
+#endif
+}
+
+// ***********************************************************************
+
+// Rebuilding the hierarchy only reads the parent and child links, so Changed<...> queries on them shouldn't match
+void Test_HierarchyRebuildDoesntChangeLinks()
+{
+	Scene scene;
+	EntityID parent = scene.NewEntity(nullptr);
+	scene.Assign<CTransform>(parent);
+	for (int i = 0; i < 3; i++)
+	{
+		EntityID child = scene.NewEntity(nullptr);
+		scene.Assign<CTransform>(child);
+		scene.SetParent(child, parent);
+	}
+
+	uint32_t version = scene.AdvanceChangeVersion();
+	CHECK(scene.hierarchyChanged);
+	TransformHeirarchy(scene, 0.0f);
+	CHECK(scene.transformHierarchy.size() == 4);
+
+	int nChangedChunks = 0;
+	for (SceneChunk chunk : SceneChunkIterator<Changed<CParent>>(scene, version))
+		nChangedChunks++;
+	for (SceneChunk chunk : SceneChunkIterator<Changed<CChild>>(scene, version))
+		nChangedChunks++;
+	CHECK(nChangedChunks == 0);
+}
+
+// ***********************************************************************
+
+// Batched reactive systems hear about entities that go away with the scene, even when nothing was flushed yet
+void Test_SceneDestructorFlushesBatches()
+{
+	g_nBatchAdded = 0;
+	g_nBatchRemoved = 0;
+
+	Scene* pScene = new Scene();
+	pScene->RegisterReactiveSystem<CTransform>(Reaction::OnAdd, CountBatchAdded);
+	pScene->RegisterReactiveSystem<CTransform>(Reaction::OnRemove, CountBatchRemoved);
+	for (int i = 0; i < 3; i++)
+		pScene->Assign<CTransform>(pScene->NewEntity(nullptr));
+	CHECK(g_nBatchAdded == 0);
+
+	delete pScene;
+	CHECK(g_nBatchAdded == 3);
+	CHECK(g_nBatchRemoved == 3);
+}
+
+// ***********************************************************************
+
+// Loading puts every entity back in its slot, and free slots are reused in the same order as in the saved scene
+void Test_BinarySceneKeepsSlots()
+{
+	Scene scene;
+	EntityID ids[10];
+	for (EntityID& id : ids)
+	{
+		id = scene.NewEntity(nullptr);
+		scene.Assign<CTransform>(id)->localPos.x = float(id.Index());
+	}
+	scene.DestroyEntity(ids[7]);
+	scene.DestroyEntity(ids[2]);
+	scene.DestroyEntity(ids[5]);
+
+	Scene* pLoaded = SceneSerializer::NewSceneFromBinary(SceneSerializer::ToBinary(scene));
+	CHECK(pLoaded != nullptr);
+	if (pLoaded == nullptr)
+		return;
+
+	CHECK(pLoaded->nActiveEntities == 7);
+	CHECK(pLoaded->entities.size() == scene.entities.size());
+	for (EntityID id : ids)
+	{
+		bool alive = scene.entities[id.Index()].id == id;
+		CHECK(pLoaded->entities[id.Index()].id.IsValid() == alive);
+		if (alive)
+			CHECK(pLoaded->Read<CTransform>(pLoaded->entities[id.Index()].id)->localPos.x == float(id.Index()));
+	}
+	for (int i = 0; i < 4; i++)
+		CHECK(pLoaded->NewEntity(nullptr).Index() == scene.NewEntity(nullptr).Index());
+	delete pLoaded;
+}
+
+// ***********************************************************************
+
+// Corrupt files must be turned away before they can make entities share slots or allocate huge amounts of memory
+void Test_BinarySceneRejectsCorruptSlots()
+{
+	eastl::string data = TransformsToBinary(3);
+	Scene* pLoaded = SceneSerializer::NewSceneFromBinary(data);
+	CHECK(pLoaded != nullptr && pLoaded->nActiveEntities == 3);
+	delete pLoaded;
+
+	// Two entities in the same block claiming one slot
+	eastl::string duplicate = data;
+	PatchIndex(duplicate, BINARY_INDICES_OFFSET + sizeof(EntityIndex), 0);
+	CHECK(SceneSerializer::NewSceneFromBinary(duplicate) == nullptr);
+
+	// More entities than the file could possibly describe
+	eastl::string tooMany = data;
+	PatchIndex(tooMany, BINARY_ENTITY_COUNT_OFFSET, 0xfffffff0);
+	CHECK(SceneSerializer::NewSceneFromBinary(tooMany) == nullptr);
+
+	// An entity claiming a slot past the end
+	eastl::string outOfRange = data;
+	PatchIndex(outOfRange, BINARY_INDICES_OFFSET, 3);
+	CHECK(SceneSerializer::NewSceneFromBinary(outOfRange) == nullptr);
+
+	// A slot that's both free and used by an entity
+	Scene scene;
+	EntityID ids[3];
+	for (EntityID& id : ids)
+		id = scene.NewEntity(nullptr);
+	scene.DestroyEntity(ids[1]);
+	eastl::string freeAndUsed = SceneSerializer::ToBinary(scene);
+	size_t freeListOffset = 5 * sizeof(uint32_t);
+	PatchIndex(freeAndUsed, freeListOffset + sizeof(uint32_t), 0);
+	CHECK(SceneSerializer::NewSceneFromBinary(freeAndUsed) == nullptr);
+}
+
+// ***********************************************************************
+
+void RegisterSceneTests()
+{
+	Test::Register("CommandBufferNewEntity", Test_CommandBufferNewEntity);
+	Test::Register("HierarchyRebuildDoesntChangeLinks", Test_HierarchyRebuildDoesntChangeLinks);
+	Test::Register("SceneDestructorFlushesBatches", Test_SceneDestructorFlushesBatches);
+	Test::Register("BinarySceneKeepsSlots", Test_BinarySceneKeepsSlots);
+	Test::Register("BinarySceneRejectsCorruptSlots", Test_BinarySceneRejectsCorruptSlots);
+}
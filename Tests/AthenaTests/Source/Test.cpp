@@ -0,0 +1,81 @@
+#include "Test.h"
+
+#include <EASTL/vector.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+	struct Entry
+	{
+		const char* name;
+		Test::TestFunc func;
+	};
+
+	eastl::vector<Entry>& GetEntries()
+	{
+		static eastl::vector<Entry> entries;
+		return entries;
+	}
+
+	int g_failedChecks = 0;
+}
+
+// ***********************************************************************
+
+// EASTL expects us to define these, see allocator.h line 194
+void* operator new[](size_t size, const char* pName, int flags, unsigned debugFlags, const char* file, int line)
+{
+	return malloc(size == 0 ? 1 : size);
+}
+void* operator new[](size_t size, size_t alignment, size_t alignmentOffset, const char* pName, int flags, unsigned debugFlags, const char* file, int line)
+{
+	if (alignment < sizeof(void*))
+		alignment = sizeof(void*);
+	void* pMemory = nullptr;
+	if (posix_memalign(&pMemory, alignment, size == 0 ? 1 : size) != 0)
+		return nullptr;
+	return pMemory;
+}
+
+// ***********************************************************************
+
+void Test::Register(const char* name, TestFunc func)
+{
+	GetEntries().push_back(Entry{ name, func });
+}
+
+// ***********************************************************************
+
+int Test::RunAll(const char* filter)
+{
+	int nRun = 0;
+	int nFailed = 0;
+	for (const Entry& entry : GetEntries())
+	{
+		if (filter && strstr(entry.name, filter) == nullptr)
+			continue;
+
+		int failedBefore = g_failedChecks;
+		entry.func();
+		bool passed = g_failedChecks == failedBefore;
+		printf("%s %s\n", passed ? "[PASS]" : "[FAIL]", entry.name);
+		fflush(stdout);
+
+		nRun++;
+		if (!passed)
+			nFailed++;
+	}
+	printf("%i of %i tests passed\n", nRun - nFailed, nRun);
+	return nFailed;
+}
+
+// ***********************************************************************
+
+void Test::Fail(const char* condition, const char* file, int line)
+{
+	printf("    CHECK(%s) failed at %s:%i\n", condition, file, line);
+	g_failedChecks++;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+// A tiny test harness for the engine's platform independent code
+// Each test is a function that checks things with CHECK, a failed check is reported and the test carries on,
+// so one run shows everything that's wrong. The process exits with a non zero code if anything failed
+
+#define CHECK(condition) (void)((condition) || (Test::Fail(#condition, __FILE__, __LINE__), 0))
+
+namespace Test
+{
+	typedef void (*TestFunc)();
+
+	void Register(const char* name, TestFunc func);
+
+	// Returns the number of tests that failed, tests with names not containing the filter are skipped
+	int RunAll(const char* filter);
+
+	void Fail(const char* condition, const char* file, int line);
+}
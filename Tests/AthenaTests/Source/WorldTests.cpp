@@ -0,0 +1,85 @@
+#include "Test.h"
+
+#include <World.h>
+#include <Systems.h>
+#include <Engine.h>
+#include <Jobs.h>
+
+namespace
+{
+	int g_nUpdates[4];
+	int g_updateOrder[4];
+	int g_nextUpdate = 0;
+
+	template<int N>
+	struct CountingSystem : public IWorldSystem
+	{
+		virtual void Activate() override {}
+		virtual void Deactivate() override {}
+		virtual void RegisterComponent(Entity* pEntity, IComponent* pComponent) override {}
+		virtual void UnregisterComponent(Entity* pEntity, IComponent* pComponent) override {}
+
+		virtual void Update(UpdateContext& ctx) override
+		{
+			g_nUpdates[N]++;
+			g_updateOrder[N] = g_nextUpdate++;
+		}
+	};
+
+	// The first three are After each other in a loop, and all exclusive so none of them can overlap, the last is free of it
+	struct LoopSystem0;
+	struct LoopSystem1;
+	struct LoopSystem2;
+	struct LoopSystem0 : public CountingSystem<0> { LoopSystem0() { access.After<LoopSystem2>(); } };
+	struct LoopSystem1 : public CountingSystem<1> { LoopSystem1() { access.After<LoopSystem0>(); } };
+	struct LoopSystem2 : public CountingSystem<2> { LoopSystem2() { access.After<LoopSystem1>(); } };
+	struct FreeSystem : public CountingSystem<3> { FreeSystem() { access.UpdatesNothing(); } };
+
+	void UpdateLoopedWorld(int nFrames)
+	{
+		for (int& nUpdates : g_nUpdates)
+			nUpdates = 0;
+
+		World world;
+		world.AddGlobalSystem<LoopSystem0>();
+		world.AddGlobalSystem<LoopSystem1>();
+		world.AddGlobalSystem<LoopSystem2>();
+		world.AddGlobalSystem<FreeSystem>();
+		world.ActivateWorld();
+
+		UpdateContext ctx;
+		ctx.pWorld = &world;
+		for (int frame = 0; frame < nFrames; frame++)
+		{
+			g_nextUpdate = 0;
+			world.OnUpdate(ctx);
+
+			// The loop is broken at the earliest registered system, the rest keep their After order
+			CHECK(g_updateOrder[0] < g_updateOrder[1]);
+			CHECK(g_updateOrder[1] < g_updateOrder[2]);
+		}
+		world.DeactivateWorld();
+
+		for (int nUpdates : g_nUpdates)
+			CHECK(nUpdates == nFrames);
+	}
+}
+
+// ***********************************************************************
+
+// Systems whose After dependencies form a loop are still updated, with and without workers to spread them over
+void Test_WorldSystemLoopStillUpdates()
+{
+	UpdateLoopedWorld(3);
+
+	Jobs::Initialize();
+	UpdateLoopedWorld(3);
+	Jobs::Destroy();
+}
+
+// ***********************************************************************
+
+void RegisterWorldTests()
+{
+	Test::Register("WorldSystemLoopStillUpdates", Test_WorldSystemLoopStillUpdates);
+}